@@ -105,7 +105,7 @@ public:
 
 	// Behavior Tree Input:
 
-	// Hang & Lowell : black board key algorithm (int) : 0 - A Star, 1 - Theta Star, 2 - Lazy Theta Star
+	// Hang & Lowell : black board key algorithm (int) : 0 - A Star, 1 - Theta Star, 2 - Lazy Theta Star, 3 - Jump Point Search
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "DoN Navigation")
 	FBlackboardKeySelector AlgorithmType;
 
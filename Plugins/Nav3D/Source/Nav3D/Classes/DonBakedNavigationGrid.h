@@ -0,0 +1,94 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/MappedFileHandle.h"
+
+/* Header of a baked navigation grid file. A baked grid is only used if every field matches the manager that loads it. */
+struct FDonBakedNavigationGridHeader
+{
+	static const uint32 ExpectedMagic = 0x56414E44; // "DNAV"
+	static const uint32 CurrentVersion = 2;
+
+	// Bytes written by Serialize, fields are stored one by one so the file never depends on struct padding
+	static const int64 SerializedSize = 48;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+
+	// Bitmask of the ECollisionChannels that were treated as obstacles
+	uint64 ObstacleChannels = 0;
+
+	float VoxelSize = 0.f;
+	int32 XGridSize = 0;
+	int32 YGridSize = 0;
+	int32 ZGridSize = 0;
+	FVector Origin = FVector::ZeroVector;
+
+	// See ADonNavigationManager::bBakeSkipsMovableObstacles
+	bool bSkipsMovableObstacles = false;
+
+	FORCEINLINE int64 NumVoxels() const { return (int64)XGridSize * YGridSize * ZGridSize; }
+
+	FORCEINLINE int64 GetFileSize() const { return SerializedSize + (NumVoxels() + 7) / 8; }
+
+	void Serialize(FArchive& Ar);
+
+	/* Returns an empty string if this header matches the expected one, otherwise a description of the first mismatch */
+	FString Validate(const FDonBakedNavigationGridHeader& Expected) const;
+};
+
+/**
+* Static obstacle occupancy for a finite world, baked offline (see ADonNavigationManager::BakeNavigationGrid) and memory-mapped at runtime.
+* The header is followed by one bit per voxel, set if the voxel is blocked, in x + y * XGridSize + z * XGridSize * YGridSize order.
+*/
+class NAV3D_API FDonBakedNavigationGrid
+{
+public:
+
+	~FDonBakedNavigationGrid() { Unload(); }
+
+	/* Maps the given file if it exists and its header matches. Mismatches are logged and leave the grid unloaded. */
+	bool Load(const FString& Filename, const FDonBakedNavigationGridHeader& ExpectedHeader);
+
+	void Unload();
+
+	FORCEINLINE bool IsLoaded() const { return Bits != nullptr; }
+
+	FORCEINLINE bool IsBlocked(int32 x, int32 y, int32 z) const
+	{
+		const int64 index = x + (int64)y * XGridSize + (int64)z * XYGridSize;
+
+		return (Bits[index >> 3] >> (index & 7)) & 1;
+	}
+
+	/* BlockedVoxels holds one entry per voxel (non-zero if blocked) in the same order as the file */
+	static bool Save(const FString& Filename, const FDonBakedNavigationGridHeader& Header, const TArray<uint8>& BlockedVoxels);
+
+private:
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// Used on platforms that can't memory-map files
+	TArray<uint8> FileData;
+
+	const uint8* Bits = nullptr;
+
+	int32 XGridSize = 0;
+	int64 XYGridSize = 0;
+};
@@ -0,0 +1,151 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SparseArray.h"
+#include "Templates/Function.h"
+
+struct FDonHierarchicalGraphEdge
+{
+	int32 Target;
+
+	// In voxels
+	float Cost;
+
+	FDonHierarchicalGraphEdge(int32 TargetIn, float CostIn) : Target(TargetIn), Cost(CostIn) {}
+};
+
+/**
+* An entrance voxel on the face of a cluster. Entrances come in pairs, one on either side of the face, connected by a single step.
+* Edges connect entrances of the same cluster and carry the cost of the shortest route between them that stays inside the cluster.
+*/
+struct FDonHierarchicalGraphNode
+{
+	FIntVector Voxel;
+
+	int32 Cluster;
+
+	// The entrance on the other side of the face
+	int32 Partner;
+
+	TArray<FDonHierarchicalGraphEdge> Edges;
+
+	FDonHierarchicalGraphNode() : Voxel(FIntVector::ZeroValue), Cluster(INDEX_NONE), Partner(INDEX_NONE) {}
+
+	FDonHierarchicalGraphNode(const FIntVector& VoxelIn, int32 ClusterIn) : Voxel(VoxelIn), Cluster(ClusterIn), Partner(INDEX_NONE) {}
+};
+
+struct FDonHierarchicalCluster
+{
+	// All entrances lying in this cluster
+	TArray<int32> Nodes;
+
+	// Entrances on this cluster's side of its +X, +Y and +Z faces. (The -X, -Y and -Z faces are owned by the neighboring clusters)
+	TArray<int32> FaceNodes[3];
+};
+
+/**
+* Abstract graph for hierarchical pathfinding (HPA*).
+*
+* The voxel grid is partitioned into cubic clusters. Every maximal connected patch of open voxel pairs across a face between two clusters
+* gets one pair of entrances, and the entrances of each cluster are connected by their intra-cluster path costs.
+* Queries search this graph first and then refine the route at voxel level within the corridor of clusters it passes through.
+* Coordinates are expressed in voxels, i.e. the same space as ADonNavigationManager::VoxelCoords
+*/
+class NAV3D_API FDonHierarchicalGraph
+{
+public:
+
+	TSparseArray<FDonHierarchicalGraphNode> Nodes;
+
+	TArray<FDonHierarchicalCluster> Clusters;
+
+	/* Derives every cluster. IsNavigable is queried for voxels within the grid only. */
+	void Build(const FIntVector& GridSizeIn, int32 ClusterSizeIn, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+
+	/* Lays out the clusters without deriving any of them. FindCorridor derives the clusters it reaches on first use. */
+	void Initialize(const FIntVector& GridSizeIn, int32 ClusterSizeIn);
+
+	/* Marks the clusters containing the given voxels, along with the faces they touch, for re-derivation. Call after their navigability changed. */
+	void MarkDirty(const TArray<FIntVector>& ChangedVoxels);
+
+	/* Re-derives everything marked dirty since the last call, once per cluster and face however many changes touched it */
+	void RebuildDirty(TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+
+	FORCEINLINE bool IsDirty() const { return DirtyClusters.Num() > 0; }
+
+	void Reset();
+
+	FORCEINLINE bool IsValid() const { return Clusters.Num() > 0; }
+
+	/* Returns the cluster containing the given voxel or INDEX_NONE if the voxel lies outside the grid */
+	int32 ClusterAt(const FIntVector& Voxel) const;
+
+	/**
+	* Searches the abstract graph from Origin to Destination and returns the clusters along the best route (origin and destination clusters included).
+	* Returns false if no route exists at this level, which is not proof that none exists at voxel level (see Build).
+	* Derives every cluster it reaches that hasn't been derived yet (see Initialize), so this writes to the graph.
+	*/
+	bool FindCorridor(const FIntVector& Origin, const FIntVector& Destination, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable, TSet<int32>& OutCorridor);
+
+	FORCEINLINE int32 NumDerivedClusters() const { return DerivedClusters.CountSetBits(); }
+
+	FORCEINLINE int32 GetClusterSize() const { return ClusterSize; }
+
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return Nodes.GetAllocatedSize() + Clusters.GetAllocatedSize() + DerivedClusters.GetAllocatedSize() + DerivedFaces.GetAllocatedSize(); }
+
+private:
+
+	FIntVector GridSize = FIntVector::ZeroValue;
+	FIntVector NumClusters = FIntVector::ZeroValue;
+	int32 ClusterSize = 16;
+
+	TSet<int32> DirtyClusters;
+	TSet<FIntPoint> DirtyFaces; // (cluster, axis)
+
+	// A cluster is derived once all six of its faces have entrances and its intra-cluster edges are in place. Faces are indexed cluster * 3 + axis.
+	TBitArray<> DerivedClusters;
+	TBitArray<> DerivedFaces;
+
+	FORCEINLINE int32 ClusterIndex(const FIntVector& ClusterCoords) const { return ClusterCoords.X + NumClusters.X * (ClusterCoords.Y + NumClusters.Y * ClusterCoords.Z); }
+	FORCEINLINE FIntVector ClusterCoordsOf(int32 Cluster) const { return FIntVector(Cluster % NumClusters.X, (Cluster / NumClusters.X) % NumClusters.Y, Cluster / (NumClusters.X * NumClusters.Y)); }
+	FORCEINLINE FIntVector ClusterMin(int32 Cluster) const { return ClusterCoordsOf(Cluster) * ClusterSize; }
+	FIntVector ClusterMax(int32 Cluster) const;
+
+	/* Neighboring cluster along +Axis or INDEX_NONE at the edge of the grid */
+	int32 NextCluster(int32 Cluster, int32 Axis) const;
+
+	/* Neighboring cluster along -Axis or INDEX_NONE at the edge of the grid */
+	int32 PreviousCluster(int32 Cluster, int32 Axis) const;
+
+	/* Derives the cluster unless it already has been, along with any of its faces still missing entrances */
+	void DeriveCluster(int32 Cluster, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+	void DeriveFace(int32 Cluster, int32 Axis, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+
+	void BuildEntrances(int32 Cluster, int32 Axis, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+	void RemoveEntrances(int32 Cluster, int32 Axis);
+	void BuildIntraClusterEdges(int32 Cluster, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+
+	/* Dijkstra over the voxels of a single cluster (6 direct and 12 implicit neighbors, diagonals don't cut corners). Unreached voxels cost MAX_flt. */
+	void SearchCluster(int32 Cluster, const FIntVector& From, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable, TArray<float>& OutCosts) const;
+
+	FORCEINLINE int32 LocalIndex(int32 Cluster, const FIntVector& Voxel) const
+	{
+		const FIntVector local = Voxel - ClusterMin(Cluster);
+
+		return local.X + ClusterSize * (local.Y + ClusterSize * local.Z);
+	}
+};
@@ -0,0 +1,138 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+
+/**
+* Incremental search (D* Lite) over voxel coordinates, kept alive across queries of the same agent.
+*
+* The search runs backwards from the goal, so the agent's voxel (the start) may move between queries without discarding anything.
+* When voxels change navigability only the part of the search tree that depended on them is repaired, instead of searching from scratch.
+* Voxels are connected through their 6 direct and 12 implicit neighbors. Diagonals don't cut corners, which keeps every edge symmetric.
+* Costs and the heuristic are measured in voxels.
+*/
+class NAV3D_API FDonIncrementalPlanner
+{
+public:
+
+	/* Discards the search tree and starts over towards a new goal */
+	void Reset(const FIntVector& Start, const FIntVector& Goal);
+
+	/* Discards the search tree and releases its memory. The planner is invalid until the next Reset. */
+	void Discard();
+
+	FORCEINLINE bool IsValid() const { return bIsValid; }
+
+	FORCEINLINE const FIntVector& GetStart() const { return Start; }
+	FORCEINLINE const FIntVector& GetGoal() const { return Goal; }
+
+	/* Moves the start to the agent's current voxel. The search tree is kept. */
+	void MoveStart(const FIntVector& NewStart);
+
+	/* Records a voxel whose navigability changed. The search tree is repaired around it on the next Step. Safe to call from any thread. */
+	void NotifyVoxelChanged(const FIntVector& Voxel);
+
+	/**
+	* Applies pending changes and expands a single voxel. IsNavigable must return false for voxels outside the world.
+	* Each voxel is only asked about once per Step, see TakeNumProbes.
+	* Returns true once the search is complete, after which HasPath tells whether the goal can be reached.
+	*/
+	bool Step(TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+
+	/* Number of IsNavigable calls made since the last call to this, so callers can charge them against their budget */
+	FORCEINLINE int32 TakeNumProbes() { const int32 numProbes = NumProbes; NumProbes = 0; return numProbes; }
+
+	bool HasPath() const;
+
+	/* Walks the search tree from the start to the goal */
+	bool ExtractPath(TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable, TArray<FIntVector>& OutPath) const;
+
+	FORCEINLINE int32 NumStates() const { return States.Num(); }
+
+private:
+
+	struct FKey
+	{
+		float Primary;
+		float Secondary;
+
+		FKey() : Primary(MAX_flt), Secondary(MAX_flt) {}
+		FKey(float PrimaryIn, float SecondaryIn) : Primary(PrimaryIn), Secondary(SecondaryIn) {}
+
+		FORCEINLINE bool operator<(const FKey& Other) const { return Primary < Other.Primary || (Primary == Other.Primary && Secondary < Other.Secondary); }
+		FORCEINLINE bool operator==(const FKey& Other) const { return Primary == Other.Primary && Secondary == Other.Secondary; }
+	};
+
+	struct FState
+	{
+		float G = MAX_flt;
+		float Rhs = MAX_flt;
+
+		// Key the state is currently queued with, if bIsQueued
+		FKey QueuedKey;
+		bool bIsQueued = false;
+	};
+
+	struct FQueueEntry
+	{
+		FKey Key;
+		FIntVector Voxel;
+
+		FQueueEntry(const FKey& KeyIn, const FIntVector& VoxelIn) : Key(KeyIn), Voxel(VoxelIn) {}
+
+		// (for TArray's heap functions, which build a min-heap)
+		FORCEINLINE bool operator<(const FQueueEntry& Other) const { return Key < Other.Key; }
+	};
+
+	bool bIsValid = false;
+
+	FIntVector Start = FIntVector::ZeroValue;
+	FIntVector Goal = FIntVector::ZeroValue;
+
+	// Accumulated heuristic offset for start moves, keeps old keys valid
+	float KeyModifier = 0.f;
+
+	TMap<FIntVector, FState> States;
+
+	// Binary heap with lazy deletion: entries whose key no longer matches their state's QueuedKey are skipped
+	TArray<FQueueEntry> Queue;
+
+	TSet<FIntVector> PendingChanges;
+	FCriticalSection PendingChangesLock;
+
+	// Navigability of every voxel probed during the current Step. Expanding one voxel re-evaluates the edges of all its neighbors, which overlap heavily.
+	TMap<FIntVector, bool> ProbeCache;
+	int32 NumProbes = 0;
+
+	static float Heuristic(const FIntVector& A, const FIntVector& B);
+
+	/* Cost of moving between two neighboring voxels, MAX_flt if either is blocked or a diagonal would cut a corner */
+	static float EdgeCost(const FIntVector& From, const FIntVector& To, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+
+	static void GetNeighbors(const FIntVector& Voxel, TArray<FIntVector, TInlineAllocator<18>>& OutNeighbors);
+
+	FORCEINLINE float GetG(const FIntVector& Voxel) const { const FState* state = States.Find(Voxel); return state ? state->G : MAX_flt; }
+	FORCEINLINE float GetRhs(const FIntVector& Voxel) const { const FState* state = States.Find(Voxel); return state ? state->Rhs : MAX_flt; }
+
+	FKey CalculateKey(const FIntVector& Voxel) const;
+	void UpdateVertex(const FIntVector& Voxel, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+	void ApplyPendingChanges(TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+
+	/* Drops stale entries off the top of the queue */
+	void PruneQueue();
+};
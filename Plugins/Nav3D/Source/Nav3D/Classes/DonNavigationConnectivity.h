@@ -0,0 +1,77 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+/**
+* Connected components of the navigable voxels of a finite world, used to reject queries between voxels that can't possibly reach each other.
+*
+* Voxels are connected through their 6 direct and 12 implicit neighbors (every move the path solver makes, the outer corners included, passes through these).
+* Components are labeled by a flood fill at startup and kept up to date with a union-find over labels: a voxel that opens up joins the components around it.
+* A voxel that becomes blocked simply leaves its component, which is never split. Components may therefore over-approximate connectivity after obstacles
+* move in (queries between them are searched as usual) but never under-approximate it, so a rejected query is truly unreachable as long as every voxel
+* that becomes navigable is reported through MarkNavigable. (ADonNavigationManager does so for dynamic collision updates and whenever a voxel is sampled)
+*/
+class NAV3D_API FDonNavigationConnectivity
+{
+public:
+
+	/* Labels every voxel. IsNavigable is queried once per voxel. */
+	void Build(const FIntVector& GridSizeIn, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable);
+
+	void Reset();
+
+	FORCEINLINE bool IsValid() const { return Labels.Num() > 0; }
+
+	/* Call after a voxel became navigable. Merges the components of its navigable neighbors. */
+	void MarkNavigable(const FIntVector& Voxel);
+
+	/* Call after a voxel became blocked */
+	void MarkBlocked(const FIntVector& Voxel);
+
+	/* True unless the voxel is inside the grid and labeled blocked, i.e. whether MarkNavigable would have nothing to do */
+	FORCEINLINE bool IsLabeledNavigable(const FIntVector& Voxel) const { return !IsValid() || !IsInsideGrid(Voxel) || Labels[LinearIndex(Voxel)] != INDEX_NONE; }
+
+	/* Returns false only if both voxels are navigable and lie in different components. Voxels outside the grid or not currently navigable are given the benefit of doubt. */
+	bool MayBeConnected(const FIntVector& A, const FIntVector& B) const;
+
+	/* Number of distinct components (including any that no longer hold a navigable voxel) */
+	int32 NumComponents() const;
+
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return Labels.GetAllocatedSize() + Parents.GetAllocatedSize(); }
+
+private:
+
+	FIntVector GridSize = FIntVector::ZeroValue;
+
+	// Label of every voxel, INDEX_NONE for blocked voxels
+	TArray<int32> Labels;
+
+	// Union-find forest over labels
+	TArray<int32> Parents;
+
+	FORCEINLINE bool IsInsideGrid(const FIntVector& Voxel) const
+	{
+		return (uint32)Voxel.X < (uint32)GridSize.X && (uint32)Voxel.Y < (uint32)GridSize.Y && (uint32)Voxel.Z < (uint32)GridSize.Z;
+	}
+
+	FORCEINLINE int32 LinearIndex(const FIntVector& Voxel) const { return Voxel.X + GridSize.X * (Voxel.Y + GridSize.Y * Voxel.Z); }
+	FORCEINLINE FIntVector VoxelAt(int32 Index) const { return FIntVector(Index % GridSize.X, (Index / GridSize.X) % GridSize.Y, Index / (GridSize.X * GridSize.Y)); }
+
+	int32 FindRoot(int32 Label) const;
+	int32 FindRootAndCompress(int32 Label);
+};
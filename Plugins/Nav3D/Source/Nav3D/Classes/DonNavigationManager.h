@@ -15,6 +15,15 @@
 #pragma once
 
 #include "DonNavigationCommon.h"
+#include "DonSparseVoxelOctree.h"
+#include "DonHierarchicalGraph.h"
+#include "DonNavigationConnectivity.h"
+#include "DonIncrementalPlanner.h"
+#include "DonBakedNavigationGrid.h"
+#include "DonVoxelCollisionProfileStore.h"
+#include "DonVoxelRasterizer.h"
+#include "DonVoxelOccupancyCache.h"
+#include "DonNavigationSearchState.h"
 #include "Multithreading/DonDrawDebugThreadSafe.h"
 #include "CollisionQueryParams.h"
 #include "WorldCollision.h"
@@ -34,29 +43,25 @@ enum class EDonNavigationQueryStatus : uint8
 	Success,
 	Failure,
 	QueryHasNoSolution,
-	TimedOut
+	TimedOut,
+	PartialSuccess
 };
 
-struct FDonNavigationDynamicCollisionNotifyee;
-
 /**
 * This is the basic unit of pathfinding for Finite Worlds.
 * Infinite Worlds (Unbound Manager) rely directly on FVectors
+*
+* Only the state read by the pathfinding hot loop is stored per voxel (2 bytes). A voxel's grid coordinates and world location
+* are derived from its index in NAVVolumeData (see ADonNavigationManager::VoxelCoords / VoxelLocation) and dynamic collision listeners
+* live in a sparse side table on the manager (see ADonNavigationManager::VoxelCollisionNotifyees).
 */
 USTRUCT()
 struct FDonNavigationVoxel
 {
 	GENERATED_USTRUCT_BODY()	
 	
-	int32 X;
-	int32 Y;
-	int32 Z;
-
-	FVector Location;
 	uint8 NumResidents = 0;
 	bool bIsInitialized = false;
-	
-	TArray<FDonNavigationDynamicCollisionNotifyee> DynamicCollisionNotifyees;
 
 	bool FORCEINLINE CanNavigate() { return NumResidents == 0; }
 
@@ -67,23 +72,6 @@ struct FDonNavigationVoxel
 		else
 			NumResidents = NumResidents > 0 ? NumResidents - 1 : 0;
 	}
-	
-	void BroadcastCollisionUpdates();
-
-	static float DistanceL2(const FDonNavigationVoxel& A, const FDonNavigationVoxel& B)
-	{
-		return sqrtf((A.X - B.X)*(A.X - B.X) + (A.Y - B.Y)*(A.Y - B.Y) + (A.Z - B.Z)*(A.Z - B.Z));
-	}
-
-	static float DistanceL1(const FDonNavigationVoxel& A, const FDonNavigationVoxel& B)
-	{
-		return fabs(A.X - B.X) + fabs(A.Y - B.Y) + fabs(A.Z - B.Z);
-	}
-	
-	friend bool operator== (const FDonNavigationVoxel& A, const FDonNavigationVoxel& B)
-	{
-		return A.X == B.X && A.Y == B.Y && A.Z == B.Z;
-	}
 
 	FDonNavigationVoxel(){}	
 };
@@ -101,12 +89,8 @@ struct FDonVoxelCollisionProfile
 	
 	TArray<FVector> RelativeVoxelOccupancy;	
 
-	/** 
-	* Note:- These references are only valid so long as NAVVolumeData (see ADonNavigationManager) is not modified in any way.
-	* Presently, NAVVolumeData is populated once and only once (at the beginning of the game) and with this model, the references are safe to rely upon.
-	*/	
-
-	TArray<FDonNavigationVoxel*> WorldVoxelsOccupied;
+	// Note:- Profiles may be shared by several meshes (see CustomCacheIdentifier), so the voxels a mesh currently occupies are tracked per mesh instead.
+	// See ADonNavigationManager::DynamicObstacleVoxels
 
 };
 
@@ -121,11 +105,13 @@ struct FDonNavigationDynamicCollisionPayload
 	
 	void* CustomDelegatePayload;	
 	
-	FDonNavigationVoxel Voxel;
+	/* Grid coordinates and world location of the voxel being listened to */
+	FIntVector VoxelId;
+	FVector VoxelLocation;
 
 	FDonNavigationDynamicCollisionPayload(){}
 
-	FDonNavigationDynamicCollisionPayload(void* CustomDelegatePayloadIn, FDonNavigationVoxel VoxelIn) : CustomDelegatePayload(CustomDelegatePayloadIn), Voxel(VoxelIn) {}
+	FDonNavigationDynamicCollisionPayload(void* CustomDelegatePayloadIn, FIntVector VoxelIdIn, FVector VoxelLocationIn) : CustomDelegatePayload(CustomDelegatePayloadIn), VoxelId(VoxelIdIn), VoxelLocation(VoxelLocationIn) {}
 };
 
 DECLARE_DYNAMIC_DELEGATE_OneParam(FDonNavigationDynamicCollisionDelegate, const FDonNavigationDynamicCollisionPayload&, Data); // note: non-dynamic delegate can't be used as a function parameter apparently
@@ -141,6 +127,9 @@ struct FDonNavigationDynamicCollisionNotifyee
 
 	FDonNavigationDynamicCollisionPayload Payload;
 
+	// ADonNavigationManager::CollisionListenerSerial as of the last time this listener was registered with its voxel
+	uint32 RegisteredAt = 0;
+
 	FDonNavigationDynamicCollisionNotifyee(){}
 
 	FDonNavigationDynamicCollisionNotifyee(FDonNavigationDynamicCollisionDelegate ListenerIn, FDonNavigationDynamicCollisionPayload PayloadIn) : Listener(ListenerIn), Payload(PayloadIn)
@@ -155,72 +144,145 @@ struct FDonNavigationDynamicCollisionNotifyee
 };
 
 // Finite World data structure:
-// Nested Structs for aggregating world voxels across three axes:
-USTRUCT()
-struct FDonNavVoxelY
+// Voxels are grouped into 8x8x8 bricks and each brick is stored contiguously, so neighboring voxels stay close together in memory
+// and every lookup is a handful of shifts plus one (unsigned) bounds check per axis.
+//
+// The whole grid is reserved as a single block of virtual address space up front, which keeps voxel pointers and indices stable,
+// but physical memory is only committed one page (a few bricks) at a time when a voxel in that page is first touched.
+// Memory therefore scales with the explored volume rather than the bounding box of the world.
+//
+// The grid may also be addressed as a ring buffer (see Scroll): logical coordinates are rotated by RingOffset before lookup, so a window
+// that moves through the world only resets the slabs scrolling into view while every other voxel keeps its storage, pointer and index.
+struct FDonNavVoxelGrid
 {
-	GENERATED_USTRUCT_BODY()
+	static const int32 BrickShift = 3;
+	static const int32 BrickMask = (1 << BrickShift) - 1;
+	static const int32 VoxelsPerBrickShift = 3 * BrickShift;
 
-	UPROPERTY()
-	TArray<FDonNavigationVoxel> Z;	
+	int32 XSize = 0;
+	int32 YSize = 0;
+	int32 ZSize = 0;
 
-	void AddZ(const FDonNavigationVoxel& volume)
-	{
-		Z.Add(volume);
-	}
+	int32 XBricks = 0;
+	int32 XYBricks = 0;
+	int32 NumBricks = 0;
 
-	FDonNavVoxelY()
-	{
-	}
-};
+	/* Storage coordinates of logical voxel (0, 0, 0). Always zero unless the grid has been scrolled. */
+	FIntVector RingOffset = FIntVector::ZeroValue;
 
-USTRUCT()
-struct FDonNavVoxelX
-{
-	GENERATED_USTRUCT_BODY()
+	/* A page is the unit of residency: the smallest power of two number of bricks that fills the platform's commit granularity */
+	int32 VoxelsPerPageShift = 0;
+	int32 NumPages = 0;
+	SIZE_T BytesPerPage = 0;
 
-	UPROPERTY()
-	TArray<FDonNavVoxelY> Y;	
+	FDonNavVoxelGrid() {}
+	~FDonNavVoxelGrid() { ClearAll(); }
+
+	FDonNavVoxelGrid(const FDonNavVoxelGrid&) = delete;
+	FDonNavVoxelGrid& operator=(const FDonNavVoxelGrid&) = delete;
+
+	void Init(int32 InXSize, int32 InYSize, int32 InZSize);
+
+	void ClearAll();
 
-	void AddY(const FDonNavVoxelY& YPlaneVolume)
+	/* Number of voxels in the world (excluding padding in partially filled bricks at the edges) */
+	FORCEINLINE int32 Num() const { return XSize * YSize * ZSize; }
+
+	FORCEINLINE bool IsValidIndex(int32 x, int32 y, int32 z) const
 	{
-		Y.Add(YPlaneVolume);
+		return (uint32)x < (uint32)XSize && (uint32)y < (uint32)YSize && (uint32)z < (uint32)ZSize;
 	}
 
-	FDonNavVoxelX()
+	FORCEINLINE int32 IndexAt(int32 x, int32 y, int32 z) const
 	{
-	}
-};
+		// Ring buffer rotation. Coordinates are in range, so a single conditional subtraction wraps them:
+		x += RingOffset.X;
+		y += RingOffset.Y;
+		z += RingOffset.Z;
+		x -= x >= XSize ? XSize : 0;
+		y -= y >= YSize ? YSize : 0;
+		z -= z >= ZSize ? ZSize : 0;
 
-USTRUCT()
-struct FDonNavVoxelXYZ
-{
-	GENERATED_USTRUCT_BODY()
+		const int32 brick = (x >> BrickShift) + (y >> BrickShift) * XBricks + (z >> BrickShift) * XYBricks;
 
-	UPROPERTY()
-	TArray<FDonNavVoxelX> X;	
+		return (brick << VoxelsPerBrickShift) | (x & BrickMask) | ((y & BrickMask) << BrickShift) | ((z & BrickMask) << (2 * BrickShift));
+	}
 
-	void AddX(const FDonNavVoxelX& XPlaneVolume)
+	FORCEINLINE int32 IndexOf(const FDonNavigationVoxel* Voxel) const { return (int32)(Voxel - Voxels); }
+
+	FORCEINLINE FIntVector CoordsOf(int32 Index) const
 	{
-		X.Add(XPlaneVolume);
+		const int32 brick = Index >> VoxelsPerBrickShift;
+		const int32 brickXY = brick % XYBricks;
+
+		// Storage coordinates, rotated back into logical coordinates:
+		int32 x = (((brickXY % XBricks) << BrickShift) | (Index & BrickMask)) - RingOffset.X;
+		int32 y = (((brickXY / XBricks) << BrickShift) | ((Index >> BrickShift) & BrickMask)) - RingOffset.Y;
+		int32 z = (((brick / XYBricks) << BrickShift) | ((Index >> (2 * BrickShift)) & BrickMask)) - RingOffset.Z;
+
+		return FIntVector(x < 0 ? x + XSize : x, y < 0 ? y + YSize : y, z < 0 ? z + ZSize : z);
 	}
 
-	void ClearAll()
+	FORCEINLINE int32 PageOf(int32 Index) const { return Index >> VoxelsPerPageShift; }
+
+	/* No bounds checking, see ADonNavigationManager::VolumeAtUnsafe */
+	FORCEINLINE FDonNavigationVoxel& At(int32 x, int32 y, int32 z) { return AtIndex(IndexAt(x, y, z)); }
+
+	FORCEINLINE FDonNavigationVoxel& AtIndex(int32 Index)
 	{
-		for (FDonNavVoxelX& _x : X)
-		{
-			for (FDonNavVoxelY& _y : _x.Y)
-				_y.Z.Empty();
+		const int32 page = PageOf(Index);
 
-			_x.Y.Empty();
-		}
+		if (PageStates[page] != EPageState::Referenced)
+			TouchPage(page);
 
-		X.Empty();
+		return Voxels[Index];
 	}
 
-	FDonNavVoxelXYZ()
+	/*
+	* Moves the window by Shift voxels: logical voxel (x, y, z) afterwards refers to what was logical voxel (x, y, z) + Shift before.
+	* Storage that scrolled out of view on one side now backs the slabs scrolling into view on the other, callers should ResetRegion those.
+	*/
+	void Scroll(const FIntVector& Shift);
+
+	/* Resets every resident voxel in the logical region [Min, Max) to its default (free and not yet sampled) state. Uncommitted pages already read as default. */
+	void ResetRegion(const FIntVector& Min, const FIntVector& Max);
+
+	/* Pages hosting dynamic obstacles are never evicted, see ADonNavigationManager::DynamicCollisionUpdateForMesh */
+	void Pin(const FDonNavigationVoxel* Voxel);
+	void Unpin(const FDonNavigationVoxel* Voxel);
+
+	/*
+	* Decommits resident pages until at most MaxResidentPages remain, using a clock sweep so that recently touched pages get a second chance.
+	* Pinned pages and pages for which IsPageInUse returns true are skipped. Returns the number of pages evicted.
+	* Note:- Any voxel pointer into an evicted page is invalid afterwards; callers must ensure none are held.
+	*/
+	int32 EvictColdPages(int32 MaxResidentPages, TFunctionRef<bool(int32 Page)> IsPageInUse);
+
+	FORCEINLINE int32 NumResidentPages() const { return ResidentPageCount; }
+	FORCEINLINE int32 BricksPerPage() const { return 1 << (VoxelsPerPageShift - VoxelsPerBrickShift); }
+	FORCEINLINE SIZE_T GetReservedSize() const { return (SIZE_T)NumPages * BytesPerPage; }
+	FORCEINLINE SIZE_T GetCommittedSize() const { return (SIZE_T)ResidentPageCount * BytesPerPage; }
+
+private:
+
+	enum EPageState : uint8
 	{
-	}	
+		Uncommitted,
+		Resident,
+		Referenced // resident and touched since the last eviction sweep
+	};
+
+	FDonNavigationVoxel* Voxels = nullptr;
+	FPlatformMemory::FPlatformVirtualMemoryBlock VirtualMemory;
+
+	TArray<uint8> PageStates;
+	TArray<int32> PagePins;
+	int32 ResidentPageCount = 0;
+	int32 EvictionClockHand = 0;
+
+	FCriticalSection CommitLock;
+
+	void TouchPage(int32 Page);
 };
 
 /**
@@ -231,7 +293,7 @@ struct FDoNNavigationQueryParams
 {
 	GENERATED_USTRUCT_BODY()
 
-	// Hang & Lowell : 0 - A Star, 1 - Theta Star, 2 - Lazy Theta Star
+	// Hang & Lowell : 0 - A Star, 1 - Theta Star, 2 - Lazy Theta Star, 3 - Jump Point Search (finite worlds only, others fall back to A Star)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation")
 	int32 AlgorithmType = 0;
 
@@ -246,6 +308,12 @@ struct FDoNNavigationQueryParams
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation")
 	float QueryTimeout = 3.f;
 
+	/** Instead of failing a query that times out, return the path to the explored voxel closest to the destination (with status PartialSuccess)
+	*   so the pawn can make progress while a follow-up query continues from wherever it ends up. Only applies to finite worlds.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation")
+	bool bAllowPartialPath = false;
+
 	/* 
 	*  If enabled, your A.I.'s origin or destination will be slightly nudged to accommodate tricky scenarios where
 	*  your A.I. needs to start or finish its pathfinding flush with a collision body (eg: hiding right next to a wall)
@@ -291,6 +359,35 @@ struct FDoNNavigationQueryParams
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation")
 	bool bForceRescheduleQuery = false;	
 
+	/** Keeps the search tree of this query alive after it completes, so the next query by the same actor towards the same destination
+	*   (typically a repath after a dynamic obstacle invalidated the path) only repairs the part of the tree the obstacle affected.
+	*   Only applies to finite worlds and pawns that occupy a single voxel. The search tree is held until the destination changes
+	*   or ADonNavigationManager::DiscardIncrementalSearch is called.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation")
+	bool bIncrementalReplanning = false;
+
+	/** Anytime search (ARA*): the first path is found quickly by inflating the heuristic with AnytimeInitialHeuristicWeight, then refined
+	*   in passes of decreasing weight until it is optimal or AnytimeTimeBudget runs out, whichever comes first. The best path found so far
+	*   can be fetched at any point through ADonNavigationManager::GetAnytimeBestPath. Only applies to finite worlds.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation")
+	bool bAnytimeSearch = false;
+
+	/** Heuristic weight of the first anytime pass. A path found with weight W is at most W times longer than the optimal path. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation", meta = (ClampMin = "1.0"))
+	float AnytimeInitialHeuristicWeight = 3.f;
+
+	/** How much the heuristic weight drops with every refinement pass */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation", meta = (ClampMin = "0.0"))
+	float AnytimeHeuristicWeightStep = 0.5f;
+
+	/** Wall-clock seconds the solver may spend refining, counted from the end of the first pass, before it settles for the best path found so far.
+	*   Applies on the worker thread as well, unlike QueryTimeout.
+	*   (QueryTimeout still applies to the query as a whole: a query that reaches it while refining settles for the best path as well) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DoN Navigation")
+	float AnytimeTimeBudget = 0.05f;
+
 	/** Generic pointer allowing you to store anything you like to be passed back as payload.
 	*   Typically used for passing unqiue identifiers in situations where you can't otherwise identify the task owner
 	*   (Eg: Behavior tree singleton nodes)
@@ -352,28 +449,58 @@ struct FDoNNavigationDebugParams
 	}
 };
 
-/** This structure is simply a wrapper around FVector that implements a dummy comparison operator enabling its use with an std::pair driven priority queue*/
-struct FDonNavigationLocVector : public FVector
+/**
+* Unbound worlds: integer voxel coordinates (as returned by ADonNavigationManager::VolumeIdAt) packed into 64 bits, 21 bits per axis.
+* That covers a million voxels in either direction along each axis (see IsInRange). The solver works on these exclusively, world locations are only derived for the path solution.
+*/
+struct FDonNavigationVoxelKey
 {
-	FDonNavigationLocVector(){}
+	static const int32 BitsPerAxis = 21;
+	static const int32 AxisBias = 1 << (BitsPerAxis - 1);
+	static const uint64 AxisMask = (1ull << BitsPerAxis) - 1;
+
+	uint64 Packed = 0;
 
-	FDonNavigationLocVector(FVector Vector)
+	FDonNavigationVoxelKey(){}
+
+	FDonNavigationVoxelKey(int32 X, int32 Y, int32 Z)
+		: Packed(((uint64)(X + AxisBias) & AxisMask) | (((uint64)(Y + AxisBias) & AxisMask) << BitsPerAxis) | (((uint64)(Z + AxisBias) & AxisMask) << (2 * BitsPerAxis)))
 	{
-		X = Vector.X;
-		Y = Vector.Y;
-		Z = Vector.Z;
+		// Coordinates outside the range silently wrap around onto other voxels:
+		checkSlow(IsInRange(X, Y, Z));
 	}
 
-	friend bool operator< (const FDonNavigationLocVector& A, const FDonNavigationLocVector& B)
+	explicit FDonNavigationVoxelKey(const FIntVector& Coords) : FDonNavigationVoxelKey(Coords.X, Coords.Y, Coords.Z) {}
+
+	static FORCEINLINE bool IsInRange(int32 X, int32 Y, int32 Z)
 	{
-		// This function is simply a workaround for enabling use of FVector type with an std::pair priority queue.
-		// The value returned is irrelevant because we will be using this as the second element of the std::pair
-		// where the only first element is actually relevant for comparison.
+		return X >= -AxisBias && X < AxisBias && Y >= -AxisBias && Y < AxisBias && Z >= -AxisBias && Z < AxisBias;
+	}
+
+	static FORCEINLINE bool IsInRange(const FIntVector& Coords) { return IsInRange(Coords.X, Coords.Y, Coords.Z); }
 
-		return false;
+	FORCEINLINE FIntVector Coords() const
+	{
+		return FIntVector((int32)(Packed & AxisMask) - AxisBias, (int32)((Packed >> BitsPerAxis) & AxisMask) - AxisBias, (int32)((Packed >> (2 * BitsPerAxis)) & AxisMask) - AxisBias);
 	}
 
-	friend uint32 GetTypeHash(const FDonNavigationLocVector& Key) { return FCrc::MemCrc32(&Key, sizeof(Key)); } // similar to FVector's hash, although that uses FCrc::MemCrc_DEPRECATED instead
+	friend bool operator== (const FDonNavigationVoxelKey& A, const FDonNavigationVoxelKey& B) { return A.Packed == B.Packed; }
+
+	// Only breaks ties between equal priorities in the std::pair driven priority queue
+	friend bool operator< (const FDonNavigationVoxelKey& A, const FDonNavigationVoxelKey& B) { return A.Packed < B.Packed; }
+
+	// Each axis lives in its own bit range, so mix them all into the low 32 bits (MurmurHash3's 64 bit finalizer)
+	friend uint32 GetTypeHash(const FDonNavigationVoxelKey& Key)
+	{
+		uint64 hash = Key.Packed;
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ull;
+		hash ^= hash >> 33;
+
+		return (uint32)hash;
+	}
 };
 
 /** 
@@ -406,6 +533,8 @@ struct FDoNNavigationQueryData
 	// Unbound:
 	FVector OriginVolumeCenter;
 	FVector DestinationVolumeCenter;
+	FDonNavigationVoxelKey OriginVoxel_Unbound;
+	FDonNavigationVoxelKey DestinationVoxel_Unbound;
 
 	FDonVoxelCollisionProfile VoxelCollisionProfile;
 
@@ -417,14 +546,45 @@ struct FDoNNavigationQueryData
 
 	using priority_t = double;
 
-	DoNNavigation::PriorityQueue<FDonNavigationVoxel*, priority_t> Frontier;
-	TSet<FDonNavigationVoxel*> VolumeClosedList;
-	TMap<FDonNavigationVoxel*, priority_t> VolumeVsCostMap;
-	TMap<FDonNavigationVoxel*, FDonNavigationVoxel*> VolumeVsGoalTrajectoryMap;
 
-	DoNNavigation::PriorityQueue<FDonNavigationLocVector, priority_t> Frontier_Unbound;
-	TMap<FDonNavigationLocVector, priority_t> VolumeVsCostMap_Unbound;
-	TMap<FDonNavigationLocVector, FDonNavigationLocVector> VolumeVsGoalTrajectoryMap_Unbound;
+	/* Costs, parents, the closed list and the frontier (open list), borrowed from ADonNavigationManager::SearchStatePool from the first solver iteration until the query completes */
+	FDonNavigationSearchState* SearchState = nullptr;
+
+	DoNNavigation::PriorityQueue<FDonNavigationVoxelKey, priority_t> Frontier_Unbound;
+	TMap<FDonNavigationVoxelKey, priority_t> VolumeVsCostMap_Unbound;
+	TMap<FDonNavigationVoxelKey, FDonNavigationVoxelKey> VolumeVsGoalTrajectoryMap_Unbound;
+
+	// Sparse voxel octree: (nodes are indices into ADonNavigationManager::SparseVoxelOctree)
+	bool bSparseOctreeQuery = false;
+	int32 OriginNode_Sparse = INDEX_NONE;
+	int32 DestinationNode_Sparse = INDEX_NONE;
+
+	DoNNavigation::PriorityQueue<int32, priority_t> Frontier_Sparse;
+	TSet<int32> NodeClosedList_Sparse;
+	TMap<int32, priority_t> NodeVsCostMap_Sparse;
+	TMap<int32, int32> NodeVsGoalTrajectoryMap_Sparse;
+
+	// Hierarchical pathfinding: the voxel search is confined to the clusters along the route found in ADonNavigationManager::HierarchicalGraph
+	bool bHierarchicalQuery = false;
+	bool bCorridorResolved_Hierarchical = false;
+	TSet<int32> Corridor_Hierarchical;
+
+	// Incremental replanning: the search tree is owned by ADonNavigationManager::IncrementalPlanners and outlives the query
+	bool bIncrementalQuery = false;
+	TSharedPtr<FDonIncrementalPlanner, ESPMode::ThreadSafe> IncrementalPlanner;
+
+	// Partial paths: the closed voxel nearest to the destination so far, see bAllowPartialPath
+	FDonNavigationVoxel* ClosestVolume_Partial = nullptr;
+	float ClosestDistance_Partial = MAX_flt;
+
+	// Anytime search: the heuristic weight of the current pass (1 for all other queries) and the path of the last completed pass
+	bool bAnytimeQuery = false;
+	bool bSolutionSettled_Anytime = false;
+	float HeuristicWeight_Anytime = 1.f;
+	double RefinementStartTime_Anytime = -1.0; // Wall-clock time the first pass completed at, negative until then. (SolverTimeTaken doesn't advance on the worker thread)
+	TArray<int32> Inconsistent_Anytime;
+	TArray<FDonNavigationVoxel*> VolumeSolution_Anytime;
+	TArray<FVector> PathSolution_Anytime;
 
 	// Optimization state variables
 	bool bOptimizationInProgress = false;
@@ -433,6 +593,9 @@ struct FDoNNavigationQueryData
 
 	// Iteration Stats	
 	int32 SolverIterationCount = 0;
+
+	// Work done by the last solver iteration beyond what a single iteration accounts for (eg: voxels scanned by a jump), charged against the per-tick budget
+	int32 SolverIterationsCharged = 0;
 	float SolverTimeTaken = 0.f;
 
 	// Solution			
@@ -460,6 +623,10 @@ struct FDoNNavigationQueryData
 
 	FORCEINLINE FString GetActorName() { return Actor.IsValid() ? Actor->GetName() : FString();	}
 
+	FORCEINLINE float GetRefinementTime_Anytime() const { return RefinementStartTime_Anytime < 0.0 ? 0.f : float(FPlatformTime::Seconds() - RefinementStartTime_Anytime); }
+
+	FORCEINLINE bool IsFrontierEmpty() { return !bIncrementalQuery && (!SearchState || SearchState->IsOpenListEmpty()) && Frontier_Unbound.empty() && Frontier_Sparse.empty(); }
+
 	void BeginOptimizationCycle()
 	{
 		optimizer_i = 0;
@@ -528,16 +695,7 @@ struct FDonNavigationQueryTask : public FDonNavigationTask
 	FDonNavigationQueryTask(FDoNNavigationQueryData InData, FDoNNavigationResultHandler ResultHandlerIn, FDonNavigationDynamicCollisionDelegate DynamicCollisionNotifierIn)
 		: Data(InData), ResultHandler(ResultHandlerIn), DynamicCollisionListener(DynamicCollisionNotifierIn)
 	{
-		if (!InData.OriginVolume) // Unbound
-		{
-			Data.Frontier_Unbound.put(InData.OriginVolumeCenter, 0);
-			Data.VolumeVsCostMap_Unbound.Add(InData.OriginVolumeCenter, 0);
-		}
-		else
-		{
-			Data.Frontier.put(InData.OriginVolume, 0);
-			Data.VolumeVsCostMap.Add(InData.OriginVolume, 0);
-		}
+		// Note:- the frontier is seeded by the manager, see BeginVoxelSearch (finite worlds) and SchedulePathfindingTask (unbound worlds)
 		Data.QueryStatus = EDonNavigationQueryStatus::InProgress;
 		RequestType = EDonNavigationRequestType::New;
 	}
@@ -565,9 +723,14 @@ struct FDonMeshIdentifier
 
 	uint32 HashValue;
 
+	// Quantized rotation and scale this identifier refers to (only used when keying collision profiles, see ADonNavigationManager::GetCollisionProfileId)
+	bool bIsPosed = false;
+	FIntVector RotationBucket = FIntVector::ZeroValue;
+	FIntVector ScaleBucket = FIntVector::ZeroValue;
+
 	friend bool operator== (const FDonMeshIdentifier& A, const FDonMeshIdentifier& B)
 	{
-		return A.UniqueTag.IsEqual(B.UniqueTag);			
+		return A.UniqueTag.IsEqual(B.UniqueTag) && A.bIsPosed == B.bIsPosed && A.RotationBucket == B.RotationBucket && A.ScaleBucket == B.ScaleBucket;
 	}
 
 	friend uint32 GetTypeHash(const FDonMeshIdentifier& Other)
@@ -587,6 +750,17 @@ struct FDonMeshIdentifier
 			HashValue = GetTypeHash(CustomCacheIdentifier);
 	}
 
+	FDonMeshIdentifier WithPose(const FIntVector& RotationBucketIn, const FIntVector& ScaleBucketIn) const
+	{
+		FDonMeshIdentifier posed = *this;
+		posed.bIsPosed = true;
+		posed.RotationBucket = RotationBucketIn;
+		posed.ScaleBucket = ScaleBucketIn;
+		posed.HashValue = HashCombine(HashValue, HashCombine(GetTypeHash(RotationBucketIn), GetTypeHash(ScaleBucketIn)));
+
+		return posed;
+	}
+
 private:
 
 	FName GetUniqueMeshTag(UPrimitiveComponent* InMesh)
@@ -604,6 +778,44 @@ private:
 
 typedef TMap<FDonMeshIdentifier, FDonVoxelCollisionProfile> DonVoxelProfileCache;
 
+/* A profile that was actually sampled (rather than derived), along with the exact pose its mesh was sampled in. Profiles for other poses are derived from this. */
+struct FDonSampledCollisionProfile
+{
+	FQuat Rotation;
+	FVector Scale;
+
+	TArray<FVector> RelativeVoxelOccupancy;
+
+	FDonSampledCollisionProfile() : Rotation(FQuat::Identity), Scale(FVector(1.f)) {}
+
+	FDonSampledCollisionProfile(const FQuat& RotationIn, const FVector& ScaleIn, const TArray<FVector>& RelativeVoxelOccupancyIn)
+		: Rotation(RotationIn), Scale(ScaleIn), RelativeVoxelOccupancy(RelativeVoxelOccupancyIn) {}
+};
+
+/* Pawn profiles (centered, origin voxel removed) and obstacle profiles (uncentered, origin voxel kept) of the same mesh can't stand in for one another */
+struct FDonSampledCollisionProfileKey
+{
+	FName UniqueTag;
+	bool bCenteredInVoxel;
+	bool bIgnoreMeshOriginOccupancy;
+	float BoundsScaleFactor;
+
+	FDonSampledCollisionProfileKey(FName UniqueTagIn, bool bCenteredInVoxelIn, bool bIgnoreMeshOriginOccupancyIn, float BoundsScaleFactorIn)
+		: UniqueTag(UniqueTagIn), bCenteredInVoxel(bCenteredInVoxelIn), bIgnoreMeshOriginOccupancy(bIgnoreMeshOriginOccupancyIn), BoundsScaleFactor(BoundsScaleFactorIn) {}
+
+	bool operator==(const FDonSampledCollisionProfileKey& Other) const
+	{
+		return UniqueTag == Other.UniqueTag && bCenteredInVoxel == Other.bCenteredInVoxel && bIgnoreMeshOriginOccupancy == Other.bIgnoreMeshOriginOccupancy && BoundsScaleFactor == Other.BoundsScaleFactor;
+	}
+
+	friend uint32 GetTypeHash(const FDonSampledCollisionProfileKey& Key)
+	{
+		const uint32 flags = (Key.bCenteredInVoxel ? 1 : 0) | (Key.bIgnoreMeshOriginOccupancy ? 2 : 0);
+
+		return HashCombine(GetTypeHash(Key.UniqueTag), HashCombine(GetTypeHash(Key.BoundsScaleFactor), flags));
+	}
+};
+
 USTRUCT()
 struct FDonNavigationDynamicCollisionTask : public FDonNavigationTask
 {
@@ -612,9 +824,14 @@ struct FDonNavigationDynamicCollisionTask : public FDonNavigationTask
 	FDonMeshIdentifier MeshId;
 	uint32 TaskHashValue;
 
+	// Collision profile cache key, i.e. MeshId in the pose the mesh had when the task was prepared
+	FDonMeshIdentifier ProfileId;
+	FQuat MeshRotation = FQuat::Identity;
+	FVector MeshScale = FVector(1.f);
+
 	FDonCollisionSamplerCallback ResultHandler;
 	
-	FDonNavigationVoxel MeshOriginalVolume;
+	FIntVector MeshOriginalVolume;
 
 	FVector MeshOriginalExtents;
 
@@ -624,15 +841,27 @@ struct FDonNavigationDynamicCollisionTask : public FDonNavigationTask
 
 	bool bDisableCacheUsage = false;	
 
+	/* Key under which the sampled profile is persisted across sessions (empty if it shouldn't be) */
+	FString PersistentProfileKey;
+
 	bool bUseCheapBoundsCollision = false;
 	
 	float BoundsScaleFactor = 1.f;
+
+	// In-place sampling: the mesh transform and sampling region captured when the task was prepared (see ADonNavigationManager::bSampleMeshCollisionInPlace)
+	bool bSampleInPlace = false;
+	FTransform SamplingTransform;
+	FIntVector SamplingMinCoords;
+	FIntVector SamplingOriginCoords;
 	
 	FCollisionObjectQueryParams ObjectParams;
 	FCollisionQueryParams CollisionParams;
 
 	bool bDrawDebug = false;
 
+	// Set once the game thread has run ADonNavigationManager::PrepareDynamicCollisionTask, after which nothing about the mesh is read again off the game thread
+	bool bPrepared = false;
+
 	// Internal processing:
 	int32 i, j, k;
 	int xLength, yLength, zLength;	
@@ -665,7 +894,7 @@ struct FDonNavigationDynamicCollisionTask : public FDonNavigationTask
 	FDonNavigationDynamicCollisionTask(){}
 	virtual ~FDonNavigationDynamicCollisionTask() {}
 
-	FDonNavigationDynamicCollisionTask(FDonMeshIdentifier MeshIdIn, FDonCollisionSamplerCallback ResultHandlerIn, FDonNavigationVoxel MeshOriginalVolumeIn, bool bDisableCacheUsageIn, bool bReloadCollisionCacheIn, bool bUseCheapBoundsCollisionIn, float BoundsScaleFactorIn, bool bDrawDebugIn)
+	FDonNavigationDynamicCollisionTask(FDonMeshIdentifier MeshIdIn, FDonCollisionSamplerCallback ResultHandlerIn, FIntVector MeshOriginalVolumeIn, bool bDisableCacheUsageIn, bool bReloadCollisionCacheIn, bool bUseCheapBoundsCollisionIn, float BoundsScaleFactorIn, bool bDrawDebugIn)
 		: MeshId(MeshIdIn), ResultHandler(ResultHandlerIn), MeshOriginalVolume(MeshOriginalVolumeIn), bReloadCollisionCache(bReloadCollisionCacheIn), bDisableCacheUsage(bDisableCacheUsageIn), bUseCheapBoundsCollision(bUseCheapBoundsCollisionIn), BoundsScaleFactor(BoundsScaleFactorIn), bDrawDebug(bDrawDebugIn)
 	{
 		i = j = k = 0;
@@ -683,6 +912,17 @@ struct FDonNavigationDynamicCollisionTask : public FDonNavigationTask
 	}	
 };
 
+/* A path query held back while the voxel grid waits to scroll, see ADonNavigationManager::ScrollVoxelGrid */
+struct FDonHeldPathfindingQuery
+{
+	TWeakObjectPtr<AActor> Actor;
+	FVector Destination;
+	FDoNNavigationQueryParams QueryParams;
+	FDoNNavigationDebugParams DebugParams;
+	FDoNNavigationResultHandler ResultHandler;
+	FDonNavigationDynamicCollisionDelegate DynamicCollisionListener;
+};
+
 struct FCollisionShape;
 class USceneComponent;
 class UBillboardComponent;
@@ -715,9 +955,119 @@ protected:
 	FCollisionQueryParams VoxelCollisionQueryParams;
 	FCollisionQueryParams VoxelCollisionQueryParams2;
 	TMap<FDonNavigationVoxel*, TArray <FDonNavigationVoxel*>> NavGraphCache;
+
+	/* Dynamic collision listeners keyed by voxel index. Sparse since only voxels along active paths are ever listened to. */
+	TMap<int32, TArray<FDonNavigationDynamicCollisionNotifyee>> VoxelCollisionNotifyees;
+
+	/* Listeners are added by the worker thread and removed/broadcast from the game thread */
+	FCriticalSection VoxelCollisionNotifyeesLock;
+
+	/* Bumped for every listener registered (guarded by VoxelCollisionNotifyeesLock), so that obstacles can tell which listeners arrived after their last update */
+	uint32 CollisionListenerSerial = 0;
+
+	void BroadcastCollisionUpdates(FDonNavigationVoxel* Volume);
+
+	/* Static occupancy baked offline, memory-mapped at BeginPlay if available */
+	FDonBakedNavigationGrid BakedNavigationGrid;
+
+	void SetupVoxelCollisionQueryParams();
+	FDonBakedNavigationGridHeader MakeBakedNavigationGridHeader();
+	FString GetBakedNavigationGridFilename();
+	bool LoadBakedNavigationGrid();
+	bool IsRegionBlockedForBake(const FVector& Center, const FVector& Extent);
+	void InitializeVoxelFromBakedGrid(FDonNavigationVoxel& Volume);
+
+	/* Coarse view of NAVVolumeData: large obstacle-free regions collapse into single leaves. Single voxel leaves defer to NAVVolumeData for navigability. */
+	FDonSparseVoxelOctree SparseVoxelOctree;
+
+	/* Read by the path solver (worker thread), written when dynamic obstacles split leaves (game thread) */
+	FRWLock SparseVoxelOctreeLock;
+
+	void BuildSparseVoxelOctree();
+	bool IsSparseNodeNavigable(int32 NodeIndex);
+	FVector SparseNodeLocation(int32 NodeIndex);
+	FVector SparsePortalLocation(int32 NodeA, int32 NodeB);
+
+	/* Clusters of NAVVolumeData with precomputed entrances and intra-cluster costs, see bUseHierarchicalPathfinding */
+	FDonHierarchicalGraph HierarchicalGraph;
+
+	/* Written by the path solver as corridors reach clusters for the first time, and when dynamic obstacles enter or leave voxels */
+	FRWLock HierarchicalGraphLock;
+
+	void BuildHierarchicalGraph();
+
+	/* Dynamic obstacles only mark the clusters they touch, the solver re-derives them in one batch before it next searches (see FlushHierarchicalGraphUpdates) */
+	void MarkHierarchicalGraphDirty(const TArray<FIntVector>& ChangedVoxels);
+	void FlushHierarchicalGraphUpdates();
+	void ResolveHierarchicalCorridor(FDoNNavigationQueryData& Data);
+	bool IsWithinHierarchicalCorridor(const FDoNNavigationQueryData& Data, FDonNavigationVoxel* Volume) const;
+
+	/* Connected components of navigable voxels, see bRejectUnreachableQueries */
+	FDonNavigationConnectivity Connectivity;
+
+	/* Read when queries are scheduled (game thread), written when dynamic obstacles enter or leave voxels */
+	FRWLock ConnectivityLock;
+
+	void BuildConnectivity();
+
+	/* Labels navigable voxels of a freshly sampled block that the connectivity still considers blocked (eg: bricks evicted and sampled again) */
+	void ReconcileConnectivityWithSamples(const FIntVector& Min, int32 Size);
+
+	/* Retained search trees of actors that asked for bIncrementalReplanning */
+	TMap<TWeakObjectPtr<AActor>, TSharedPtr<FDonIncrementalPlanner, ESPMode::ThreadSafe>> IncrementalPlanners;
+
+	/* Acquired when scheduling and discarding (game thread) and when dynamic obstacles enter or leave voxels (either thread) */
+	FCriticalSection IncrementalPlannersLock;
+
+	TSharedPtr<FDonIncrementalPlanner, ESPMode::ThreadSafe> AcquireIncrementalPlanner(AActor* Actor);
+	void NotifyIncrementalPlanners(const TArray<FIntVector>& VoxelsFreed, const TArray<FDonNavigationVoxel*>& VoxelsOccupied);
+
+	/* Paths of the last completed pass of every anytime query in flight, see bAnytimeSearch */
+	TMap<TWeakObjectPtr<AActor>, TArray<FVector>> AnytimeBestPaths;
+
+	/* Written by the path solver (worker thread), read by anyone asking for the best path so far (game thread) */
+	FCriticalSection AnytimeBestPathsLock;
+
+	void BeginAnytimeRefinementPass(FDonNavigationQueryTask& Task);
+	bool PreparePartialSolution(FDonNavigationQueryTask& Task);
+	void SettleAnytimeSearch(FDoNNavigationQueryData& Data);
 	TMap<FDonMeshIdentifier, FDonVoxelCollisionProfile> VoxelCollisionProfileCache_WorkerThread;
 	TMap<FDonMeshIdentifier, FDonVoxelCollisionProfile> VoxelCollisionProfileCache_GameThread;
 
+	/* PrepareDynamicCollisionTask also runs on the game thread (scheduling, coalesced updates), so the worker thread's cache needs guarding after all */
+	FCriticalSection VoxelCollisionProfileCacheLock;
+
+	/* Backs both caches above across sessions. Loaded at BeginPlay, saved at EndPlay. */
+	FDonVoxelCollisionProfileStore PersistentVoxelCollisionProfiles;
+
+	FString GetPersistentVoxelCollisionProfileFilename();
+	FString GetPersistentVoxelCollisionProfileKey(const FDonMeshIdentifier& ProfileId, bool bCenteredInVoxel, bool bIgnoreMeshOriginOccupancy, bool bUseCheapBoundsCollision, float BoundsScaleFactor);
+
+	/* Hash of the collision geometry a mesh is sampled against, so re-authored collision never matches a stale persistent profile */
+	uint32 GetCollisionGeometryFingerprint(UPrimitiveComponent* Mesh);
+
+	/* Last sampled profile of every mesh and sampling mode, the source for profiles of poses that haven't been seen yet */
+	TMap<FDonSampledCollisionProfileKey, FDonSampledCollisionProfile> SampledCollisionProfiles;
+
+	/* Written when sampling completes (worker thread) and when pawn profiles are sampled (game thread), read from both */
+	FCriticalSection SampledCollisionProfilesLock;
+
+	/* Voxels currently blocked by each dynamic obstacle, flushed when it moves on. See DynamicCollisionUpdateForMesh */
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, TSet<FDonNavigationVoxel*>> DynamicObstacleVoxels;
+
+	/* CollisionListenerSerial as of each dynamic obstacle's last update, see DynamicCollisionUpdateForMesh */
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, uint32> DynamicObstacleListenerSerials;
+
+	FDonMeshIdentifier GetCollisionProfileId(const FDonMeshIdentifier& MeshId);
+	void AddSampledCollisionProfile(const FDonSampledCollisionProfileKey& Key, const FDonSampledCollisionProfile& Profile);
+	bool DeriveCollisionProfileForPose(const FDonSampledCollisionProfileKey& Key, const FQuat& Rotation, const FVector& Scale, FDonVoxelCollisionProfile& OutProfile);
+
+	/* Analytic alternative to SampleVoxelCollisionForMesh for meshes with simple collision (see FDonVoxelRasterizer). Returns false if the mesh doesn't qualify. */
+	bool RasterizeVoxelCollisionForMesh(UPrimitiveComponent* Mesh, bool bCenteredInVoxel, bool bIgnoreMeshOriginOccupancy, float BoundsScaleFactor, FDonVoxelCollisionProfile& OutProfile);
+
+	/* Tests a voxel against the mesh's own collision body without moving it. VoxelCenter is relative to SamplingTransform, so the mesh may have moved on since. */
+	bool OverlapsMeshInPlace(UPrimitiveComponent* Mesh, const FVector& VoxelCenter, const FTransform& SamplingTransform);
+
 	bool bRegistrationCompleteForComponents;
 	int32 RegistrationIndexCurrent;
 	int32 MaxRegistrationsPerTick;	
@@ -735,7 +1085,10 @@ public:
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = Translation)
 	UBillboardComponent* Billboard;	
 
-	FDonNavVoxelXYZ NAVVolumeData;
+	FDonNavVoxelGrid NAVVolumeData;
+
+	/* Held by the worker thread whenever it has work, so that bricks are only ever evicted while no task holds voxel pointers */
+	FCriticalSection NAVVolumeDataLock;
 
 	/* Represents the side of the cube used to build the voxel. Eg: a value of 300 produces a cube 300x300x300*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Dimensions")
@@ -781,10 +1134,103 @@ public:
 	//
 
 	/** If set to true, collision checks will be performed for each and every voxel when the game begins. Warning: This can slow down loading of the game significantly.
-	 *  Default behavior is set to false, meaning collision data will always be lazy loaded upn demand. This is the recommended approach */
+	 *  Default behavior is set to false, meaning collision data will always be lazy loaded upn demand. This is the recommended approach
+	 *  The bake is spread across all cores and may be cancelled from the progress dialog, in which case remaining voxels fall back to lazy loading. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game Startup")
 	bool PerformCollisionChecksOnStartup;
 
+	/** If set to true and a baked navigation grid matching this manager's settings exists (see BakeNavigationGrid), static occupancy is read
+	 *  from it instead of being sampled with physics overlaps at runtime. This also supersedes PerformCollisionChecksOnStartup. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game Startup")
+	bool bUseBakedNavigationGrid = true;
+
+	/** If set to true, BakeNavigationGrid leaves out Movable obstacles, so their voxels start out navigable at runtime.
+	 *  Only enable this if every movable obstacle reports its occupancy through ScheduleDynamicCollisionUpdate; by default they are baked
+	 *  just like the live sampler would see them, and dynamic collision updates clear them once they move. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game Startup")
+	bool bBakeSkipsMovableObstacles = false;
+
+	/** Samples every voxel against the obstacles in the level in the editor and saves the result next to the level (<Level>_<Manager>.donnav).
+	 *  Re-bake whenever static geometry, VoxelSize, grid dimensions, the manager's location, ObstacleQueryChannels or bBakeSkipsMovableObstacles change.
+	 *  Note: for packaged builds add the level's folder to "Additional Non-Asset Directories to Copy" so the file is shipped. */
+	UFUNCTION(CallInEditor, Category = "Game Startup")
+	void BakeNavigationGrid();
+
+	/** Caps the number of 8x8x8 voxel bricks kept in memory. Once exceeded, bricks that haven't been touched recently (and that nobody is listening to
+	 *  for dynamic collisions) are evicted whenever the solver is idle. Evicted bricks are simply re-sampled on demand. 0 means no limit. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Bound Worlds")
+	int32 MaxResidentVoxelBricks = 0;
+
+	/** If set to true, voxel collision profiles sampled for dynamic obstacles are saved to Saved/DonNavigation at EndPlay and preloaded at BeginPlay,
+	 *  so each mesh asset is only sampled once per scale, rotation and VoxelSize rather than once per session. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings")
+	bool bUsePersistentVoxelCollisionProfileCache = true;
+
+	/** If set to true, obstacles whose collision consists only of boxes, spheres and capsules (shape components, or meshes with simple collision only)
+	 *  are voxelized analytically instead of with one physics overlap per voxel. This is orders of magnitude faster and never moves the obstacle. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Dynamic Collisions")
+	bool bUseAnalyticVoxelization = true;
+
+	/** If set to true, ScheduleDynamicCollisionUpdate keeps at most one pending update per mesh: newer requests replace older ones (only the latest ResultHandler is notified)
+	 *  and the update is processed at the next Tick using the mesh's transform at that time. Cached profiles are translated to the new location straight away.
+	 *  Ideal for obstacles that request an update every tick while moving. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Dynamic Collisions")
+	bool bCoalesceDynamicCollisionUpdates = false;
+
+	/** If set to true, meshes are sampled by testing voxels directly against the mesh's own collision body (in the mesh's local space) rather than teleporting the mesh
+	 *  into its home voxel and running world overlaps. This never disturbs physics and makes sampling safe to run off the game thread. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Dynamic Collisions")
+	bool bSampleMeshCollisionInPlace = true;
+
+	/** If set to true, collision profiles are cached per quantized rotation and scale of each mesh (see CollisionProfileRotationStep and CollisionProfileScaleStep)
+	 *  so rotating and scaling obstacles no longer need bReloadCollisionCache or hand made CustomCacheIdentifiers. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Dynamic Collisions")
+	bool bPoseAwareCollisionProfileCache = true;
+
+	/** Rotations within this many degrees (per axis) of each other share a collision profile */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Dynamic Collisions", meta = (ClampMin = "1", ClampMax = "90"))
+	float CollisionProfileRotationStep = 15.f;
+
+	/** Scales within this much of each other share a collision profile */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Dynamic Collisions", meta = (ClampMin = "0.01"))
+	float CollisionProfileScaleStep = 0.05f;
+
+	/** If set to true, the profile for a pose that hasn't been seen yet is computed by transforming the mesh's last sampled profile instead of sampling the mesh again.
+	 *  Derived profiles are accurate to about a voxel. Turn this off for intricate meshes where that matters (each new pose is then sampled once and cached). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Dynamic Collisions", meta = (EditCondition = "bPoseAwareCollisionProfileCache"))
+	bool bDeriveCollisionProfilesForNewPoses = true;
+
+	/** Voxels are sampled coarse-to-fine: a single overlap first tests a block of this many voxels per side, and only blocks that hit something are subdivided.
+	 *  In open areas this cuts the physics queries made at startup and during lazy loading by up to 8x (2) or 64x (4). Rounded up to a power of two, 1 samples every voxel individually. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 VoxelSamplingBlockSize = 4;
+
+	/** If set to true, a sparse voxel octree is built over the world at startup and path queries search its leaves instead of individual voxels.
+	 *  Large open spaces then cost a handful of nodes instead of thousands of voxels. Pawns with multi-voxel collision profiles always search the voxel grid.
+	 *  Finite worlds only. The octree is built from the baked navigation grid, or from the voxels sampled by PerformCollisionChecksOnStartup.
+	 *  Without either, building it would sample the entire world, so queries search the voxel grid instead. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sparse Voxel Octree")
+	bool bUseSparseVoxelOctree = false;
+
+	/** If set to true, the world is partitioned into clusters whose entrances and internal path costs are precomputed (HPA*).
+	 *  Queries search this cluster graph first and then solve at voxel level only within the corridor of clusters on the chosen route,
+	 *  so long queries cost about as much as their route is complex rather than as long as it is. Dynamic obstacles re-derive only the clusters they touch.
+	 *  Finite worlds only. Pawns with multi-voxel collision profiles and sparse octree queries search the whole grid.
+	 *  With a baked navigation grid the whole graph is built from it at startup. Otherwise each cluster is sampled and derived the first time a corridor reaches it. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hierarchical Pathfinding")
+	bool bUseHierarchicalPathfinding = false;
+
+	/** Edge length of a cluster in voxels. Larger clusters make for a smaller cluster graph but wider corridors to refine. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hierarchical Pathfinding", meta = (EditCondition = "bUseHierarchicalPathfinding", ClampMin = "4", ClampMax = "64"))
+	int32 HierarchicalClusterSize = 16;
+
+	/** If set to true, navigable voxels are labeled by connected component at startup and the labels are kept up to date as dynamic obstacles move.
+	 *  Queries whose origin and destination lie in different components fail immediately in SchedulePathfindingTask instead of exhausting the solver or timing out.
+	 *  Finite worlds only. Costs 4 bytes per voxel. Labels are read from the baked navigation grid, or from the voxels sampled by PerformCollisionChecksOnStartup.
+	 *  Without either, labeling would sample the entire world, so queries are not rejected at all. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings")
+	bool bRejectUnreachableQueries = false;
+
 	// Performance settings - Bound worlds (if multi-threading is enabled, these will be overwritten at BeginPlay with the values in the next section!)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings")
 	bool bMultiThreadingEnabled = true;
@@ -801,6 +1247,26 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Bound Worlds | Multithreaded")
 	int32 MaxCollisionSolverIterationsOnThread = 500;
 
+	/** Dynamic collision samples spanning at least this many voxels are split into slabs and sampled in parallel across the task graph, finishing in a single iteration
+	 *  rather than eating into the collision solver budget over many frames. Requires bSampleMeshCollisionInPlace. 0 disables parallel sampling. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Bound Worlds | Multithreaded", meta = (ClampMin = "0"))
+	int32 ParallelCollisionSamplingThreshold = 512;
+
+	/** Path queries keep their costs and closed list in dense per-voxel search states that are recycled between queries, so steady-state pathfinding doesn't allocate.
+	 *  This many states are kept around for reuse, set it to the number of queries you usually have in flight at once. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Bound Worlds", meta = (ClampMin = "0"))
+	int32 MaxPooledSearchStates = 4;
+
+	/** Jump Point Search (AlgorithmType 3): a jump that scans this many voxels without finding a jump point stops there and queues the voxel it reached,
+	 *  so a single expansion never sweeps across the whole grid. Every scanned voxel is charged as one path solver iteration. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Bound Worlds", meta = (ClampMin = "1"))
+	int32 MaxJumpPointScanLength = 32;
+
+	/** bIncrementalReplanning: a search tree that grows past this many voxels is discarded and the query falls back to the regular solver.
+	 *  Retained trees cost roughly 64 bytes per voxel, per actor. 0 means no limit. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Bound Worlds", meta = (ClampMin = "0"))
+	int32 MaxIncrementalPlannerStates = 100000;
+
 	// Performance settings - Infinite worlds
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Infinite Worlds | SingleThread")
 	int32 MaxPathSolverIterationsPerTick_Unbound = 15;	
@@ -814,6 +1280,20 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Infinite Worlds | Multithreaded")
 	int32 MaxCollisionSolverIterationsOnThread_Unbound = 500;
 
+	/** If set to true, the outcome of every voxel collision test is cached (by voxel coordinates) and shared across queries, so neighboring expansions
+	 *  and subsequent queries don't repeat the same physics overlaps. ScheduleDynamicCollisionUpdate and InvalidateNavigationRegion invalidate it.
+	 *  Off by default, because obstacles that move without calling either are only picked up once their cached voxels expire (see UnboundOccupancyCacheMaxAge). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Infinite Worlds")
+	bool bCacheUnboundVoxelOccupancy = false;
+
+	/** Memory cap for the occupancy cache, roughly 32 bytes per voxel. Least recently used voxels are evicted first. 0 means no limit. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Infinite Worlds", meta = (ClampMin = "0"))
+	int32 UnboundOccupancyCacheMaxVoxels = 1000000;
+
+	/** Cached voxels are re-tested after at most twice this many seconds, to pick up geometry changes nobody told us about. 0 means they never expire. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Settings | Infinite Worlds", meta = (ClampMin = "0"))
+	float UnboundOccupancyCacheMaxAge = 0.5f;
+
 	void RefreshPerformanceSettings();
 
 	// World generation
@@ -852,6 +1332,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")
 	void Debug_DrawVoxelCollisionProfile(UPrimitiveComponent* MeshOrPrimitive, bool bDrawPersistent = false, float Duration = 2.f);
 
+	/** Infinite worlds: forgets the cached navigability of every voxel overlapping Region. Call this whenever geometry there changes without going through ScheduleDynamicCollisionUpdate
+	 *  (e.g. after streaming in or generating procedural content). */
+	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")
+	void InvalidateNavigationRegion(const FBox& Region);
+
 	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")	
 	void Debug_ClearAllVolumes();
 
@@ -865,6 +1350,9 @@ private:
 	
 	// Graph generation
 	void GenerateNavigationVolumePixels();	
+
+	/* Samples collision for every voxel across all cores. Invoked at startup when PerformCollisionChecksOnStartup is set. */
+	void BakeVoxelCollisions();
 	void BuildNAVNetwork();
 	void DiscoverNeighborsForVolume(int32 x, int32 y, int32 z, TArray<FDonNavigationVoxel*>& neighbors);
 	void AppendImplictDOFNeighborsForVolume(int32 x, int32 y, int32 z, TArray<FDonNavigationVoxel*>& Neighbors);
@@ -926,6 +1414,12 @@ private:
 	TQueue<FDonNavigationDynamicCollisionTask> CompletedCollisionTasks;
 	TQueue<FDonNavigationVoxel*> DynamicCollisionBroadcastQueue;
 
+	bool HasPendingWork_WorkerThread();
+	void EvictColdVoxelBricks();
+
+	/* True if no task holds voxel pointers or grid coordinates. Only meaningful while NAVVolumeDataLock is held. */
+	bool IsSolverIdle();
+
 	void ReceiveAsyncNavigationTasks();
 	//void ReceiveAsyncAbortRequests(); // deprecated
 	void ReceiveAsyncCollisionTasks();
@@ -961,7 +1455,7 @@ public:
 
 	FORCEINLINE bool IsValidVolume(int x, int y, int z)
 	{
-		return NAVVolumeData.X.IsValidIndex(x) && NAVVolumeData.X[x].Y.IsValidIndex(y) && NAVVolumeData.X[x].Y[y].Z.IsValidIndex(z);
+		return NAVVolumeData.IsValidIndex(x, y, z);
 	}
 
 	inline FVector LocationAtId(int32 X, int32 Y, int32 Z)
@@ -998,7 +1492,7 @@ public:
 		int32 z = (WorldLocation.Z - GetActorLocation().Z) / VoxelSize;
 
 		if (IsValidVolume(x, y, z))
-			return &NAVVolumeData.X[x].Y[y].Z[z];
+			return &NAVVolumeData.At(x, y, z);
 		else
 			return NULL;
 	}	
@@ -1006,7 +1500,7 @@ public:
 	inline FDonNavigationVoxel* VolumeAtSafe(int32 x, int32 y, int32 z)
 	{
 		if (IsValidVolume(x, y, z))
-			return &NAVVolumeData.X[x].Y[y].Z[z];
+			return &NAVVolumeData.At(x, y, z);
 		else
 			return NULL;
 	}
@@ -1017,7 +1511,30 @@ public:
 	 */
 	inline FDonNavigationVoxel& VolumeAtUnsafe(int32 x, int32 y, int32 z)
 	{
-		return NAVVolumeData.X[x].Y[y].Z[z];
+		return NAVVolumeData.At(x, y, z);
+	}
+
+	/* Voxels only store their occupancy, their coordinates and location are derived from their position in NAVVolumeData: */
+	FORCEINLINE int32 VoxelIndex(const FDonNavigationVoxel* Volume) const
+	{
+		return NAVVolumeData.IndexOf(Volume);
+	}
+
+	FORCEINLINE FIntVector VoxelCoords(const FDonNavigationVoxel* Volume) const
+	{
+		return NAVVolumeData.CoordsOf(NAVVolumeData.IndexOf(Volume));
+	}
+
+	inline FVector VoxelLocation(const FDonNavigationVoxel* Volume)
+	{
+		const FIntVector coords = VoxelCoords(Volume);
+
+		return LocationAtId(coords.X, coords.Y, coords.Z);
+	}
+
+	static float VoxelDistanceL2(const FIntVector& A, const FIntVector& B)
+	{
+		return sqrtf((A.X - B.X)*(A.X - B.X) + (A.Y - B.Y)*(A.Y - B.Y) + (A.Z - B.Z)*(A.Z - B.Z));
 	}
 
 	inline FDonNavigationVoxel* NeighborAt(FDonNavigationVoxel* Volume, FVector NeighborOffset)
@@ -1025,9 +1542,10 @@ public:
 		if (!Volume)
 			return NULL;
 
-		int32 x = Volume->X + NeighborOffset.X;
-		int32 y = Volume->Y + NeighborOffset.Y;
-		int32 z = Volume->Z + NeighborOffset.Z;
+		const FIntVector coords = VoxelCoords(Volume);
+		int32 x = coords.X + NeighborOffset.X;
+		int32 y = coords.Y + NeighborOffset.Y;
+		int32 z = coords.Z + NeighborOffset.Z;
 
 		return VolumeAtSafe(x, y, z);
 	}
@@ -1092,6 +1610,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")
 	void AbortPathfindingTask(AActor* Actor);
 
+	/** Releases the search tree retained for an actor by bIncrementalReplanning. Call this once the actor no longer needs to repath towards its destination. */
+	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")
+	void DiscardIncrementalSearch(AActor* Actor);
+
+	/** Fetches the best (unoptimized) path found so far by an actor's anytime query still in flight, see QueryParams.bAnytimeSearch.
+	*   Returns false if the query hasn't completed its first pass yet.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")
+	bool GetAnytimeBestPath(AActor* Actor, TArray<FVector>& OutPath);
+
 	/** Does this actor have an active pathfinding task already scheduled with the navigation manager? */
 	UFUNCTION(BlueprintPure, Category = "DoN Navigation")
 	bool HasTask(AActor* Actor) { return ActiveNavigationTaskOwners.Contains(Actor); }
@@ -1117,6 +1645,7 @@ public:
 	*                                             Details: By default the collision cache uses the address of each mesh component as the cache key. This has two fundamental limitations:
 	*											  1. Multiple meshes with identical collision properties will end up creating individual entries in the cache despite being the same (collision wise).
 	*											  2. Any mesh that needs to change its rotation or scale cannot use the default cache value which only works for location based translations.
+	*                                                (Unless bPoseAwareCollisionProfileCache is enabled on the manager, in which case profiles are keyed by quantized rotation and scale automatically)
 	*
 	*                                             The first limitation can be easily solved by sharing a single cache identifier across all meshes of the same type (Eg: "SolidWall_NoRotation").
 	*                                             The second limitation can be resolved either by forcibly reloading the collision cache each time using bReloadCollisionCache (not recommended, very expensive) 
@@ -1159,7 +1688,24 @@ public:
 	
 	void VoxelCacheClearByKey(const FDonMeshIdentifier &MeshId)
 	{
-		VoxelCollisionProfileCache_WorkerThread.Remove(MeshId);
+		// (every pose of the mesh)
+		{
+			FScopeLock lock(&VoxelCollisionProfileCacheLock);
+
+			for (auto it = VoxelCollisionProfileCache_WorkerThread.CreateIterator(); it; ++it)
+			{
+				if (it.Key().UniqueTag.IsEqual(MeshId.UniqueTag))
+					it.RemoveCurrent();
+			}
+		}
+
+		FScopeLock lock(&SampledCollisionProfilesLock);
+
+		for (auto it = SampledCollisionProfiles.CreateIterator(); it; ++it)
+		{
+			if (it.Key().UniqueTag.IsEqual(MeshId.UniqueTag))
+				it.RemoveCurrent();
+		}
 	}
 
 	/** 
@@ -1238,9 +1784,21 @@ protected:
 	virtual bool PrepareSolution(FDonNavigationQueryTask& Task);
 
 private:
+	void TickNavigationSolver_SparseOctree(FDonNavigationQueryTask& task);
+	bool PrepareSolution_SparseOctree(FDonNavigationQueryTask& Task);
+
+	void TickNavigationSolver_Incremental(FDonNavigationQueryTask& task);
+	bool PrepareSolution_Incremental(FDonNavigationQueryTask& Task);
 	void TickNavigationOptimizer(FDonNavigationQueryTask& task);
 	void TickNavigationOptimizerCycle(FDonNavigationQueryTask& task, int32& IterationsProcessed, const int32 MaxIterationsPerTask);
 	void TickVoxelCollisionSampler(FDonNavigationDynamicCollisionTask& Task);
+	void CompleteVoxelCollisionSampling(FDonNavigationDynamicCollisionTask& Task);
+
+	/* Samples an entire (in-place) task across the task graph, one slab per X layer. Returns false if the task doesn't qualify. */
+	bool SampleCollisionTaskInParallel(FDonNavigationDynamicCollisionTask& Task);
+
+	/* Samples voxel (i, j, k) of the task's sampling region without touching NAVVolumeData, so it is safe to call concurrently. Returns false if the voxel lies outside the world. */
+	bool SampleCollisionTaskVoxel(const FDonNavigationDynamicCollisionTask& Task, UPrimitiveComponent* Mesh, int32 i, int32 j, int32 k, bool& bOutIsOccupied);
 	void ExpandFrontierTowardsTarget(FDonNavigationQueryTask& Task, FDonNavigationVoxel* Current, FDonNavigationVoxel* Neighbor);
 	void PackageRawSolution(FDonNavigationQueryTask& task);
 	void PackageDirectSolution(FDonNavigationQueryTask& Task);
@@ -1253,14 +1811,48 @@ private:
 	FDonNavigationVoxel* LazyThetaStarReparentByLineOfSight(FDonNavigationQueryTask& Task, FDonNavigationVoxel* Current);
 	void LazyThetaStarRegressByLineOfSight(FDonNavigationQueryTask& Task, FDonNavigationVoxel* Current);
 
+	/*
+		Jump Point Search (AlgorithmType 3)
+
+		Every expanded voxel jumps along each of its 6 direct degrees of freedom and steps once along each of its 12 implicit ones.
+		A jump stops at the goal or at the first voxel whose ring of 8 voxels perpendicular to the jump opens up relative to the ring
+		behind it, i.e. wherever a shorter route could branch off the line, or after MaxJumpPointScanLength voxels. Voxels skipped in between never enter the open list.
+		Diagonals are not allowed to cut corners and the 8 outer corners (USE_26_DOFs) are not used, the path optimizer smooths those out.
+	*/
+	void ExpandJumpPointSuccessors(FDonNavigationQueryTask& Task, FDonNavigationVoxel* Current);
+	FDonNavigationVoxel* JumpStraight(FDonNavigationQueryTask& Task, const FIntVector& From, const FIntVector& Direction);
+	void ExpandFrontierByJump(FDonNavigationQueryTask& Task, FDonNavigationVoxel* Current, FDonNavigationVoxel* JumpPoint);
+	uint8 JumpPointRingMask(const FIntVector& Coords, const FIntVector& AxisU, const FIntVector& AxisV, const FDonVoxelCollisionProfile& CollisionProfile);
+	bool CanJumpThrough(const FIntVector& Coords, const FDonVoxelCollisionProfile& CollisionProfile);
+
 	// Thread-aware routines	
 	//FCriticalSection CriticalSection_Collisions;
 
 	void AddPathfindingTask(const FDonNavigationQueryTask& Task);
 	void AddDynamicCollisionTask(FDonNavigationDynamicCollisionTask& Task);
+	void DispatchDynamicCollisionTask(FDonNavigationDynamicCollisionTask& Task);
 	bool IsDynamicCollisionTaskActive(const FDonNavigationDynamicCollisionTask& Task);
+
+	/* Unbound worlds: results of CanNavigateVoxelAt by voxel coordinates, shared across queries */
+	FDonVoxelOccupancyCache UnboundOccupancyCache;
+
+	/* Unbound worlds: last known bounds of each obstacle passed to ScheduleDynamicCollisionUpdate, so the area it left is invalidated too */
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, FBox> UnboundObstacleBounds;
+
+	/* Drops obstacles that were destroyed or unregistered, invalidating the area they last occupied */
+	void ForgetRemovedUnboundObstacles();
+
+	/* Latest pending update per mesh, see bCoalesceDynamicCollisionUpdates */
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, FDonNavigationDynamicCollisionTask> CoalescedCollisionUpdates;
+	void FlushCoalescedCollisionUpdates();
 	bool PrepareDynamicCollisionTask(FDonNavigationDynamicCollisionTask& task, bool &bOverallStatus);
 	void CompleteNavigationTask(int32 TaskIndex);
+
+	/* Search states for finite world queries, see FDoNNavigationQueryData::SearchState */
+	FDonNavigationSearchStatePool SearchStatePool;
+	void BeginVoxelSearch(FDoNNavigationQueryData& Data);
+	void EndVoxelSearch(FDoNNavigationQueryData& Data);
+	FORCEINLINE FDonNavigationVoxel* VolumeAtIndex(int32 Index) { return Index != INDEX_NONE ? &NAVVolumeData.AtIndex(Index) : nullptr; }
 	void CompleteCollisionTask(const int32 TaskIndex, bool bIsSuccess);
 
 	void AbortPathfindingTask_Internal(AActor* Actor);
@@ -1269,12 +1861,20 @@ private:
 
 	// Voxel collision sampling:
 	void UpdateVoxelCollision(FDonNavigationVoxel& Volume);
+	void InitializeVoxel(FDonNavigationVoxel& Volume);
+	void ApplyVoxelSample(FDonNavigationVoxel& Volume, bool bIsBlocked);
+	bool IsRegionBlocked(const FVector& Center, const FVector& Extent);
+	int32 GetVoxelSamplingBlockSize();
+
+	/* Coarse-to-fine sampling: one overlap tests the whole block and only blocks that hit something are subdivided, down to single voxels. */
+	void SampleVoxelBlock(const FIntVector& Min, int32 Size, TFunctionRef<bool(const FVector& Center, const FVector& Extent)> IsRegionBlockedFn, TFunctionRef<void(int32 x, int32 y, int32 z, bool bIsBlocked)> OnVoxelSampled);
 	FDonVoxelCollisionProfile GetVoxelCollisionProfileFromMesh(const FDonMeshIdentifier& MeshId, bool &bResultIsValid, DonVoxelProfileCache& PreferredCache, bool bIgnoreMeshOriginOccupancy = false, bool bDisableCacheUsage = false, FName CustomCacheIdentifier = NAME_None, bool bReloadCollisionCache = false, bool bUseCheapBoundsCollision = false, float BoundsScaleFactor = 1.f, bool DrawDebug = false);
 	FDonVoxelCollisionProfile SampleVoxelCollisionForMesh(UPrimitiveComponent* Mesh, bool &bResultIsValid, bool bIgnoreMeshOriginOccupancy = false, FName CustomCacheIdentifier = NAME_None, bool bUseCheapBoundsCollision = false, float BoundsScaleFactor = 1.f, bool DrawDebug = false);
 
 	// Dynamic collision listeners:
-	void DynamicCollisionUpdateForMesh(const FDonMeshIdentifier& MeshId, FDonVoxelCollisionProfile& VoxelCollisionProfile, bool bDisableCacheUsage = false, bool bDrawDebug = false);
+	void DynamicCollisionUpdateForMesh(const FDonMeshIdentifier& MeshId, const FDonVoxelCollisionProfile& VoxelCollisionProfile, bool bDrawDebug = false);
 	void AddCollisionListenerToVolumeFromTask(FDonNavigationVoxel* Volume, FDonNavigationQueryTask& task);
+	void RemoveCollisionListenerFromVolume(FDonNavigationVoxel* Volume, const FDonNavigationDynamicCollisionDelegate& ListenerToClear);
 	FDonNavigationVoxel* AppendVolumeList(FVector Location, FDonNavigationQueryTask& task);
 	void AppendVolumeListFromRange(FVector Start, FVector End, FDonNavigationQueryTask& task);
 
@@ -1295,12 +1895,31 @@ public:
 
 protected:
 	bool CanNavigateByCollisionProfile(FDonNavigationVoxel* Volume, const FDonVoxelCollisionProfile& CollisionToTest);
-	bool CanNavigateByCollisionProfile(FVector Location, const FDonVoxelCollisionProfile& CollisionToTest);
+	bool CanNavigateByCollisionProfile(const FIntVector& Voxel, const FDonVoxelCollisionProfile& CollisionToTest);
+
+	/* Unbound worlds: CanNavigate for the voxel at the given coordinates (see VolumeIdAt), answered from UnboundOccupancyCache where possible */
+	bool CanNavigateVoxelAt(const FIntVector& Voxel);
+
+	/*
+	* Sliding windows (see ADonNavigationManagerSlidingWindow): moves the grid and the manager by Shift voxels. Voxels that remain in view keep their state,
+	* the slabs scrolling into view are reset and sampled either right away (bResampleImmediately) or on demand.
+	* Returns false without doing anything if the solver is busy, since tasks hold raw voxel pointers and grid coordinates. In that case the scroll is pending:
+	* new path queries and dynamic collision updates are held back until the next successful call (a zero Shift simply releases them) so that the solver drains.
+	*/
+	bool ScrollVoxelGrid(const FIntVector& Shift, bool bResampleImmediately = false);
+
+	bool bVoxelGridScrollPending = false;
+
+	// Path queries received while bVoxelGridScrollPending, re-submitted once the grid has scrolled. (dynamic collision updates wait in CoalescedCollisionUpdates)
+	TArray<FDonHeldPathfindingQuery> HeldPathfindingQueries;
+
+	void ReleaseHeldPathfindingQueries();
 
 private:
 
 	// Path solution generation and optimization pass
 	void PathSolutionFromVolumeSolution(const TArray<FDonNavigationVoxel*>& VolumeSolution, TArray<FVector> &PathSolution, FVector Origin, FVector Destination, const FDoNNavigationDebugParams& DebugParams);	
+	bool PathSolutionFromVolumeTrajectoryMap(FDonNavigationVoxel* OriginVolume, FDonNavigationVoxel* DestinationVolume, const FDonNavigationSearchState& SearchState, TArray<FDonNavigationVoxel*>& VolumeSolution, TArray<FVector> &PathSolution, FVector Origin, FVector Destination, const FDoNNavigationDebugParams& DebugParams);
 	void OptimizePathSolution(UPrimitiveComponent* CollisionComponent, const TArray<FVector>& PathSolution, TArray<FVector> &PathSolutionOptimized, float CollisionShapeInflation = 0.f);	
 	void OptimizePathSolution_Pass1_LineTrace(UPrimitiveComponent* CollisionComponent, const TArray<FVector>& PathSolution, TArray<FVector> &PathSolutionOptimized, float CollisionShapeInflation = 0.f);	
 
@@ -0,0 +1,70 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "DonNavigationManager.h"
+
+#include "DonNavigationManagerSlidingWindow.generated.h"
+
+/*
+* Open worlds with the speed of a Finite World: a voxel grid of XGridSize x YGridSize x ZGridSize voxels that travels along with a set of tracked agents.
+* Whenever the agents drift too far from the center of the window, the window scrolls to recenter on them. The grid is a ring buffer, so only the slabs
+* scrolling into view are reset and re-sampled while everything else (including dynamic obstacles) keeps its state. See ADonNavigationManager::ScrollVoxelGrid.
+*
+* Path queries must start and end inside the window. Agents traveling further should path to intermediate goals (eg: the point where their
+* destination's direction crosses the window) and re-query as the window follows them.
+* Baked navigation grids and the sparse voxel octree describe a fixed region of the world, so they aren't used by this manager.
+*/
+UCLASS()
+class NAV3D_API ADonNavigationManagerSlidingWindow : public ADonNavigationManager
+{
+	GENERATED_BODY()
+
+public:
+	ADonNavigationManagerSlidingWindow(const FObjectInitializer& ObjectInitializer);
+
+	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	/* The window stays centered on these actors (on the center of their bounding box when there are several) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sliding Window")
+	TArray<AActor*> TrackedAgents;
+
+	/** How far (in voxels, along any axis) the tracked agents may drift from the center of the window before it scrolls.
+	 *  Larger values scroll less often but in bigger steps, and leave the agents less room ahead of them. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sliding Window", meta = (ClampMin = "1"))
+	int32 RecenterThreshold = 8;
+
+	/** If set to true, slabs scrolling into view are sampled right away (across all cores). Otherwise they are sampled on demand,
+	 *  like any voxel the solver touches for the first time. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sliding Window")
+	bool bResampleScrolledSlabsImmediately = false;
+
+	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")
+	void TrackAgent(AActor* Agent);
+
+	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")
+	void UntrackAgent(AActor* Agent);
+
+	/* Scrolls the window so that it is centered on the tracked agents. Returns false if there are no agents or if the solver is busy (the window can only move while it is idle, so new queries are held back until it is). */
+	UFUNCTION(BlueprintCallable, Category = "DoN Navigation")
+	bool RecenterWindow();
+
+protected:
+	bool GetTrackedAgentsCenter(FVector& OutCenter);
+
+	/* Whole voxels by which the window must move to be centered on Center */
+	FIntVector GetRecenterShift(const FVector& Center);
+};
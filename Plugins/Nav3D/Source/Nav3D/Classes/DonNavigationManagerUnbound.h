@@ -19,7 +19,8 @@
 
 /*
 * Infinite Worlds! This is the unbound version of the Navigation Manager.
-* Supports unlimited map sizes. Nothing is cached, everything is looked up on-demand and for procedural games it fully eliminates the burden of having to manage dynamic collision updates.
+* Supports unlimited map sizes. There is no voxel grid, everything is looked up on-demand and for procedural games it fully eliminates the burden of having to manage dynamic collision updates.
+* (The outcome of each lookup may optionally be cached by voxel coordinates, see bCacheUnboundVoxelOccupancy. With the cache enabled, moving obstacles should call ScheduleDynamicCollisionUpdate to invalidate it.)
 * It is obviously slower than the Finite World equivalent but will benefit projects with huge maps or highly dynamic/frequently changing/procedural collision geometry.
 */
 UCLASS()
@@ -36,6 +37,6 @@ protected:
 	virtual void TickNavigationSolver(FDonNavigationQueryTask& task) override;
 	virtual bool PrepareSolution(FDonNavigationQueryTask& Task) override;
 
-	TArray<FVector> NeighborsAsVectors(FVector Location);
-	void ExpandFrontierTowardsTarget(FDonNavigationQueryTask& Task, FVector Current, FVector Neighbor);	
+	TArray<FDonNavigationVoxelKey> NeighborsAsVoxels(const FIntVector& Voxel);
+	void ExpandFrontierTowardsTarget(FDonNavigationQueryTask& Task, FDonNavigationVoxelKey Current, FDonNavigationVoxelKey Neighbor);	
 };
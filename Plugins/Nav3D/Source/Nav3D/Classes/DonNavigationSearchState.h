@@ -0,0 +1,210 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "Templates/UniquePtr.h"
+
+/**
+* A* bookkeeping for a single finite world query: the g-cost, parent and closed flag of every voxel the query has reached, addressed by voxel index
+* (see FDonNavVoxelGrid), along with the open list. Parents are voxel indices as well, so the state holds no pointers into the grid.
+*
+* The open list is an indexed 4-ary min-heap. Every voxel records its slot in the heap, so a voxel that is reached again by a cheaper route has its
+* priority decreased in place rather than being queued a second time.
+*
+* Storage mirrors the grid's 8x8x8 bricks: a brick only gets a block of entries once the query reaches one of its voxels. Brick slots and blocks
+* are stamped with the generation of the query that last used them, so starting a new query is O(1) and stale blocks are recycled on first touch.
+* Once a state has served a query of similar size, it performs no allocations at all.
+*/
+class NAV3D_API FDonNavigationSearchState
+{
+public:
+
+	/* Must match FDonNavVoxelGrid::VoxelsPerBrickShift */
+	static const int32 VoxelsPerBlockShift = 9;
+	static const int32 VoxelsPerBlock = 1 << VoxelsPerBlockShift;
+
+	/* Sizes the state for a grid of NumBricks bricks and starts a new query */
+	void NewSearch(int32 NumBricks);
+
+	FORCEINLINE bool IsVisited(int32 Index) const { return FindEntry(Index) != nullptr; }
+
+	/* MAX_flt for voxels the query hasn't reached */
+	FORCEINLINE float GetCost(int32 Index) const
+	{
+		const FEntry* entry = FindEntry(Index);
+
+		return entry ? entry->Cost : MAX_flt;
+	}
+
+	/* INDEX_NONE for the origin and for voxels the query hasn't reached */
+	FORCEINLINE int32 GetParent(int32 Index) const
+	{
+		const FEntry* entry = FindEntry(Index);
+
+		return entry ? entry->Parent : INDEX_NONE;
+	}
+
+	FORCEINLINE bool IsClosed(int32 Index) const
+	{
+		const FEntry* entry = FindEntry(Index);
+
+		return entry && entry->bClosed;
+	}
+
+	/* Records a (cheaper) way to reach the given voxel */
+	FORCEINLINE void Visit(int32 Index, float Cost, int32 Parent)
+	{
+		FEntry& entry = FindOrAddEntry(Index);
+		entry.Cost = Cost;
+		entry.Parent = Parent;
+	}
+
+	FORCEINLINE void Close(int32 Index) { FindOrAddEntry(Index).bClosed = true; }
+
+	/* Queues the voxel, or lowers its priority if it is already queued with a higher one */
+	void PushOpen(int32 Index, float Priority);
+
+	/* Removes and returns the queued voxel with the lowest priority */
+	int32 PopOpen();
+
+	/* Recomputes the priority of every queued voxel and restores the heap (anytime search changes the heuristic weight between passes) */
+	void ReprioritizeOpen(TFunctionRef<float(int32 Index)> PriorityOf);
+
+	/* Reopens every voxel for expansion, keeping costs and parents */
+	void ClearClosed();
+
+	FORCEINLINE bool IsOpenListEmpty() const { return OpenList.Num() == 0; }
+	FORCEINLINE int32 NumOpen() const { return OpenList.Num(); }
+
+	FORCEINLINE int32 NumVisited() const { return NumVisitedVoxels; }
+
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return BrickSlots.GetAllocatedSize() + Entries.GetAllocatedSize() + OpenList.GetAllocatedSize(); }
+
+private:
+
+	struct FEntry
+	{
+		float Cost;
+		int32 Parent;
+
+		// Position in OpenList, INDEX_NONE while not queued
+		int32 OpenSlot;
+
+		bool bVisited;
+		bool bClosed;
+	};
+
+	struct FOpenNode
+	{
+		float Priority;
+		int32 Index;
+	};
+
+	static const int32 OpenListArity = 4;
+
+	struct FBrickSlot
+	{
+		uint32 Generation = 0;
+		int32 Block = INDEX_NONE;
+	};
+
+	TArray<FBrickSlot> BrickSlots;
+
+	/* Blocks of VoxelsPerBlock entries, handed out to bricks in the order the query reaches them */
+	TArray<FEntry> Entries;
+
+	TArray<FOpenNode> OpenList;
+
+	int32 NumBlocksInUse = 0;
+	int32 NumVisitedVoxels = 0;
+	uint32 Generation = 0;
+
+	FORCEINLINE const FEntry* FindEntry(int32 Index) const
+	{
+		const FBrickSlot& slot = BrickSlots[Index >> VoxelsPerBlockShift];
+
+		if (slot.Generation != Generation)
+			return nullptr;
+
+		const FEntry& entry = Entries[(slot.Block << VoxelsPerBlockShift) | (Index & (VoxelsPerBlock - 1))];
+
+		return entry.bVisited ? &entry : nullptr;
+	}
+
+	FORCEINLINE FEntry& FindOrAddEntry(int32 Index)
+	{
+		FBrickSlot& slot = BrickSlots[Index >> VoxelsPerBlockShift];
+
+		if (slot.Generation != Generation)
+			AssignBlock(slot);
+
+		FEntry& entry = Entries[(slot.Block << VoxelsPerBlockShift) | (Index & (VoxelsPerBlock - 1))];
+
+		if (!entry.bVisited)
+		{
+			entry.Cost = MAX_flt;
+			entry.Parent = INDEX_NONE;
+			entry.OpenSlot = INDEX_NONE;
+			entry.bVisited = true;
+			entry.bClosed = false;
+
+			NumVisitedVoxels++;
+		}
+
+		return entry;
+	}
+
+	void AssignBlock(FBrickSlot& Slot);
+
+	/* Moves the node at Slot towards the root / the leaves until the heap property holds, keeping every moved voxel's OpenSlot in sync */
+	void SiftUp(int32 Slot);
+	void SiftDown(int32 Slot);
+
+	FORCEINLINE void PlaceOpenNode(const FOpenNode& Node, int32 Slot)
+	{
+		OpenList[Slot] = Node;
+		FindOrAddEntry(Node.Index).OpenSlot = Slot;
+	}
+};
+
+/**
+* Search states for concurrently active queries. The worker thread time-slices between all of its active queries, so each one holds on to its own state
+* from its first solver iteration until it completes or is aborted. Released states are kept for reuse, up to MaxPooledStates.
+*
+* Thread-safe: synchronous queries on the game thread may acquire states while the worker thread is running.
+*/
+class NAV3D_API FDonNavigationSearchStatePool
+{
+public:
+
+	/* Returns a state that has been reset for a new query on a grid of NumBricks bricks */
+	FDonNavigationSearchState* Acquire(int32 NumBricks);
+
+	void Release(FDonNavigationSearchState* State);
+
+	/* 0 means states are never kept for reuse */
+	void SetMaxPooledStates(int32 MaxPooledStatesIn);
+
+private:
+
+	TArray<TUniquePtr<FDonNavigationSearchState>> States;
+	TArray<FDonNavigationSearchState*> FreeStates;
+
+	int32 MaxPooledStates = 4;
+
+	FCriticalSection Lock;
+};
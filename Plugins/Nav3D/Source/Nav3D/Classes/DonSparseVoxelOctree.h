@@ -0,0 +1,101 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+/**
+* A single cubic node of the sparse voxel octree. Nodes are addressed by their index in FDonSparseVoxelOctree::Nodes.
+* Coordinates are expressed in voxels relative to the manager's grid, i.e. the same space as ADonNavigationManager::VoxelCoords
+*/
+struct FDonSparseVoxelOctreeNode
+{
+	// Min corner of this node in grid coordinates
+	FIntVector Min;
+
+	// Edge length in voxels (always a power of two)
+	int32 Size;
+
+	// Index of the first of 8 contiguous children, INDEX_NONE for leaves
+	int32 FirstChild;
+
+	// Leaves lying outside the finite world. These are never navigable.
+	bool bOutsideWorld;
+
+	FORCEINLINE bool IsLeaf() const { return FirstChild == INDEX_NONE; }
+
+	FDonSparseVoxelOctreeNode() : Min(FIntVector::ZeroValue), Size(1), FirstChild(INDEX_NONE), bOutsideWorld(false) {}
+
+	FDonSparseVoxelOctreeNode(const FIntVector& MinIn, int32 SizeIn) : Min(MinIn), Size(SizeIn), FirstChild(INDEX_NONE), bOutsideWorld(false) {}
+};
+
+/**
+* Sparse voxel octree over the finite world.
+*
+* Every leaf larger than a single voxel represents a region that was found to be entirely free of obstacles when the tree was built.
+* Single voxel leaves carry no navigability of their own - callers must consult the voxel grid for those, which keeps dynamic obstacles
+* authoritative in one place. When a dynamic obstacle moves into a large free leaf, that leaf is split down to the affected voxel (see SplitToVoxel).
+*/
+class NAV3D_API FDonSparseVoxelOctree
+{
+public:
+
+	TArray<FDonSparseVoxelOctreeNode> Nodes;
+
+	/**
+	* Builds the tree top-down. IsRegionFree is queried for every candidate node and should return true if the box spanning
+	* the given voxels contains no obstacles. Regions that are free become leaves, others are subdivided down to single voxels.
+	*/
+	void Build(const FIntVector& GridSizeIn, TFunctionRef<bool(const FIntVector& Min, int32 Size)> IsRegionFree);
+
+	void Reset();
+
+	FORCEINLINE bool IsValid() const { return Nodes.Num() > 0; }
+
+	/* Returns the leaf containing the given voxel or INDEX_NONE if the voxel lies outside the world */
+	int32 LeafAt(const FIntVector& Coords) const;
+
+	/* Collects all leaves that share a face with the given node. Leaves outside the world are skipped. */
+	void GetFaceNeighbors(int32 NodeIndex, TArray<int32>& OutNeighbors) const;
+
+	/* Collects all leaves beneath the given node (the node itself if it is a leaf). Leaves outside the world are skipped. */
+	void GetLeavesInNode(int32 NodeIndex, TArray<int32>& OutLeaves) const;
+
+	/* Subdivides whichever large leaf contains the given voxel until that voxel is a leaf of its own. Returns true if the tree changed. */
+	bool SplitToVoxel(const FIntVector& Coords);
+
+	/* Center of the shared face between two adjacent nodes, in grid coordinates (i.e. multiply by voxel size and offset by the grid origin for world space) */
+	static FVector PortalBetween(const FDonSparseVoxelOctreeNode& A, const FDonSparseVoxelOctreeNode& B);
+
+	static bool AreFaceAdjacent(const FDonSparseVoxelOctreeNode& A, const FDonSparseVoxelOctreeNode& B);
+
+	FORCEINLINE static FVector NodeCenter(const FDonSparseVoxelOctreeNode& Node) { return FVector(Node.Min) + FVector(Node.Size * 0.5f); }
+
+	int32 NumLeaves() const;
+
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return Nodes.GetAllocatedSize(); }
+
+private:
+
+	FIntVector GridSize = FIntVector::ZeroValue;
+
+	bool IsInsideWorld(const FIntVector& Min, int32 Size) const;
+	bool IsOutsideWorld(const FIntVector& Min, int32 Size) const;
+
+	void Subdivide(int32 NodeIndex);
+	void BuildNode(int32 NodeIndex, TFunctionRef<bool(const FIntVector& Min, int32 Size)> IsRegionFree);
+	void GatherLeavesInRegion(int32 NodeIndex, const FIntVector& RegionMin, const FIntVector& RegionMax, TArray<int32>& OutLeaves) const;
+};
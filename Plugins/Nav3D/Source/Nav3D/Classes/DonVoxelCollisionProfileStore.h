@@ -0,0 +1,55 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Persists voxel collision profiles (see FDonVoxelCollisionProfile::RelativeVoxelOccupancy) across sessions so that
+* dynamic obstacles sampled once never need to be sampled again. Entries are keyed by a string describing everything the
+* sampled occupancy depends on (see ADonNavigationManager::GetPersistentVoxelCollisionProfileKey).
+*
+* Accessed from both the game thread and the worker thread.
+*/
+class NAV3D_API FDonVoxelCollisionProfileStore
+{
+public:
+
+	/* Merges entries from the given file into this store. Files written by other versions of the format are ignored. */
+	bool Load(const FString& Filename);
+
+	/* Writes all entries (merged with whatever is already on disk, in case other managers share the file). Does nothing if no entries were added. */
+	bool Save(const FString& Filename);
+
+	bool Find(const FString& Key, TArray<FVector>& OutRelativeVoxelOccupancy);
+
+	void Add(const FString& Key, const TArray<FVector>& RelativeVoxelOccupancy);
+
+	int32 Num();
+
+private:
+
+	static const uint32 Magic = 0x50564F44; // "DOVP"
+	static const int32 Version = 1;
+
+	TMap<FString, TArray<FVector>> Profiles;
+
+	bool bIsDirty = false;
+
+	FCriticalSection Lock;
+
+	static bool ReadFile(const FString& Filename, TMap<FString, TArray<FVector>>& OutProfiles);
+};
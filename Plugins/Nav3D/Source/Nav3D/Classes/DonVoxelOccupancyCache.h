@@ -0,0 +1,67 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Remembers the outcome of voxel collision tests by integer voxel coordinates. Used by the unbound manager, which has no voxel grid to hold them.
+*
+* Eviction is approximately least-recently-used: entries live in two generations, lookups that hit the older generation promote the entry to the current one,
+* and whenever the current generation fills up (or ages out) it becomes the older generation and the previous older generation is dropped wholesale.
+* At most MaxEntries are kept and no entry lives longer than twice MaxAgeSeconds.
+*
+* Thread-safe: the solver reads and fills it from the worker thread while gameplay invalidates regions from the game thread.
+*/
+class NAV3D_API FDonVoxelOccupancyCache
+{
+public:
+
+	/* Returns true if the voxel is cached, in which case bOutIsBlocked holds the cached result */
+	bool Find(const FIntVector& Coords, bool& bOutIsBlocked);
+
+	/* Bumped by every invalidation. Read it before testing a voxel and pass it to Add, so results that raced an invalidation are never cached. */
+	uint32 GetInvalidationEpoch() const;
+
+	/* Ignored if the cache was invalidated since Epoch was read */
+	void Add(const FIntVector& Coords, bool bIsBlocked, uint32 Epoch);
+
+	/* Forgets every voxel within [Min, Max] (inclusive), e.g. after the geometry there has changed */
+	void InvalidateRegion(const FIntVector& Min, const FIntVector& Max);
+
+	void Empty();
+
+	int32 Num() const;
+
+	/* 0 means no limit */
+	void SetLimits(int32 MaxEntriesIn, float MaxAgeSecondsIn);
+
+private:
+
+	TMap<FIntVector, bool> Current;
+	TMap<FIntVector, bool> Previous;
+
+	double CurrentGenerationStartTime = 0.0;
+
+	int32 MaxEntries = 0;
+	float MaxAgeSeconds = 0.f;
+
+	uint32 InvalidationEpoch = 0;
+
+	mutable FCriticalSection Lock;
+
+	void RotateGenerationsIfNeeded();
+};
@@ -0,0 +1,68 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPrimitiveComponent;
+
+enum class EDonCollisionPrimitiveType : uint8
+{
+	Box,
+	Sphere,
+	Capsule
+};
+
+/**
+* A single simple collision shape, posed relative to the origin of the component that owns it (i.e. rotated and scaled like the component, but not translated into the world)
+*/
+struct FDonCollisionPrimitive
+{
+	EDonCollisionPrimitiveType Type = EDonCollisionPrimitiveType::Box;
+
+	FVector Center = FVector::ZeroVector;
+
+	FQuat Rotation = FQuat::Identity;
+
+	// Box: half extents. Sphere: X is the radius. Capsule: X is the radius, Z is the half length of the segment between the two hemispheres (along local Z)
+	FVector Extent = FVector::ZeroVector;
+};
+
+/**
+* Voxelizes simple collision (boxes, spheres and capsules) analytically, as a fast alternative to sampling a mesh with one physics overlap per voxel.
+* Capturing the primitives must happen on the game thread, rasterizing them is plain arithmetic and safe on any thread.
+*/
+class NAV3D_API FDonVoxelRasterizer
+{
+public:
+
+	/** 
+	* Collects the simple collision of a box, sphere or capsule component, or of any component whose body setup consists of nothing but box, sphere and capsule elements.
+	* Returns false if the collision can't be described exactly this way (complex or convex collision, non-uniform scale on rotated or round elements, etc.)
+	*/
+	static bool CapturePrimitives(UPrimitiveComponent* Component, TArray<FDonCollisionPrimitive>& OutPrimitives);
+
+	/**
+	* Adds the offset of every voxel overlapping the primitives to OutRelativeVoxelOccupancy, in voxels relative to the voxel containing the component origin.
+	* PivotOffset is the position of the component origin relative to the center of that voxel.
+	*/
+	static void Rasterize(const TArray<FDonCollisionPrimitive>& Primitives, const FVector& PivotOffset, float VoxelSize, TArray<FVector>& OutRelativeVoxelOccupancy);
+
+private:
+
+	static FVector GetPrimitiveExtent(const FDonCollisionPrimitive& Primitive);
+	static bool Overlaps(const FDonCollisionPrimitive& Primitive, const FVector& VoxelCenter, float HalfVoxel);
+};
@@ -281,6 +281,7 @@ void UBTTask_FlyTo::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemor
 	{
 
 	case EDonNavigationQueryStatus::Success:
+	case EDonNavigationQueryStatus::PartialSuccess: // (see TickPathNavigation for how partial paths are followed up)
 
 		//first success tick
 
@@ -303,6 +304,9 @@ void UBTTask_FlyTo::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemor
 			case 2:
 				sTime = FString::Printf(TEXT("Time elapsed for Lazy Theta*: %.4f seconds"), elapsed_seconds.count());
 				break;
+			case 3:
+				sTime = FString::Printf(TEXT("Time elapsed for JPS: %.4f seconds"), elapsed_seconds.count());
+				break;
 			default:
 				break;
 			}
@@ -345,9 +349,8 @@ void UBTTask_FlyTo::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemor
 		}
 		break;
 
-	// For advanced usecases we could support partial path traversal, etc (so we slowly progress towards the goal
-	// with each cycle of query-timeout->partial-reschedule->partial-navigate->query-timeout->partial-reschedule, etc)
-	// but for now, let's just keep things simple.
+	// Partial path traversal (QueryParams.bAllowPartialPath) slowly progresses towards the goal with each cycle of
+	// query-timeout->partial-navigate->reschedule, so only the queries that don't make any progress at all end up here:
 
 	case EDonNavigationQueryStatus::QueryHasNoSolution:
 	case EDonNavigationQueryStatus::TimedOut:
@@ -397,6 +400,17 @@ void UBTTask_FlyTo::TickPathNavigation(UBehaviorTreeComponent& OwnerComp, FBT_Fl
 	// Reached next segment:
 	if (flightDirection.Size() <= MinimumProximityRequired)
 	{
+		// End of a partial path? Carry on from here with a fresh query:
+		if (MyMemory->solutionTraversalIndex == queryResults.PathSolutionOptimized.Num() - 1 && queryResults.QueryStatus == EDonNavigationQueryStatus::PartialSuccess)
+		{
+			NavigationManager->StopListeningToDynamicCollisionsForPath(MyMemory->DynamicCollisionListener, queryResults);
+
+			if (SchedulePathfindingRequest(OwnerComp, (uint8*)MyMemory) == EBTNodeResult::Failed)
+				FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+
+			return;
+		}
+
 		// Goal reached?
 		if (MyMemory->solutionTraversalIndex == queryResults.PathSolutionOptimized.Num() - 1)
 		{
@@ -460,6 +474,11 @@ void UBTTask_FlyTo::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* Nod
 
 	myMemory->BBObserverDelegateHandle.Reset();
 
+	// Release any search tree retained for repathing (see bIncrementalReplanning)
+	APawn* pawn = OwnerComp.GetAIOwner() ? OwnerComp.GetAIOwner()->GetPawn() : nullptr;
+	if (NavigationManager && pawn)
+		NavigationManager->DiscardIncrementalSearch(pawn);
+
 	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
 }
 
@@ -0,0 +1,159 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "DonBakedNavigationGrid.h"
+#include "DonAINavigationPrivatePCH.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/BufferReader.h"
+#include "Serialization/MemoryWriter.h"
+
+void FDonBakedNavigationGridHeader::Serialize(FArchive& Ar)
+{
+	uint32 skipsMovableObstacles = bSkipsMovableObstacles ? 1 : 0;
+
+	Ar << Magic << Version << ObstacleChannels;
+	Ar << VoxelSize << XGridSize << YGridSize << ZGridSize;
+	Ar << Origin.X << Origin.Y << Origin.Z;
+	Ar << skipsMovableObstacles;
+
+	bSkipsMovableObstacles = skipsMovableObstacles != 0;
+}
+
+FString FDonBakedNavigationGridHeader::Validate(const FDonBakedNavigationGridHeader& Expected) const
+{
+	if (Magic != ExpectedMagic)
+		return FString("not a baked navigation grid");
+
+	if (Version != CurrentVersion)
+		return FString::Printf(TEXT("version %d, expected %d"), Version, CurrentVersion);
+
+	if (VoxelSize != Expected.VoxelSize)
+		return FString::Printf(TEXT("VoxelSize %f, expected %f"), VoxelSize, Expected.VoxelSize);
+
+	if (XGridSize != Expected.XGridSize || YGridSize != Expected.YGridSize || ZGridSize != Expected.ZGridSize)
+		return FString::Printf(TEXT("grid size %dx%dx%d, expected %dx%dx%d"), XGridSize, YGridSize, ZGridSize, Expected.XGridSize, Expected.YGridSize, Expected.ZGridSize);
+
+	if (!Origin.Equals(Expected.Origin, 0.1f))
+		return FString::Printf(TEXT("origin %s, expected %s"), *Origin.ToString(), *Expected.Origin.ToString());
+
+	if (ObstacleChannels != Expected.ObstacleChannels)
+		return FString("obstacle channels differ");
+
+	if (bSkipsMovableObstacles != Expected.bSkipsMovableObstacles)
+		return FString::Printf(TEXT("baked %s movable obstacles, expected %s"), bSkipsMovableObstacles ? TEXT("without") : TEXT("with"), Expected.bSkipsMovableObstacles ? TEXT("without") : TEXT("with"));
+
+	return FString();
+}
+
+bool FDonBakedNavigationGrid::Load(const FString& Filename, const FDonBakedNavigationGridHeader& ExpectedHeader)
+{
+	Unload();
+
+	IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	if (!platformFile.FileExists(*Filename))
+		return false;
+
+	const int64 fileSize = platformFile.FileSize(*Filename);
+	if (fileSize != ExpectedHeader.GetFileSize())
+	{
+		UE_LOG(DoNNavigationLog, Warning, TEXT("Baked navigation grid %s is out of date (file size %lld, expected %lld) and will be ignored. Please re-bake."), *Filename, fileSize, ExpectedHeader.GetFileSize());
+		return false;
+	}
+
+	const uint8* data = nullptr;
+
+	MappedFile.Reset(platformFile.OpenMapped(*Filename));
+	if (MappedFile)
+		MappedRegion.Reset(MappedFile->MapRegion(0, fileSize));
+
+	if (MappedRegion)
+	{
+		data = MappedRegion->GetMappedPtr();
+	}
+	else
+	{
+		MappedFile.Reset();
+
+		if (!FFileHelper::LoadFileToArray(FileData, *Filename) || FileData.Num() != fileSize)
+		{
+			UE_LOG(DoNNavigationLog, Error, TEXT("Failed to read baked navigation grid %s"), *Filename);
+			Unload();
+			return false;
+		}
+
+		data = FileData.GetData();
+	}
+
+	FDonBakedNavigationGridHeader header;
+	{
+		const bool bFreeOnClose = false;
+		FBufferReader headerReader(const_cast<uint8*>(data), FDonBakedNavigationGridHeader::SerializedSize, bFreeOnClose);
+		header.Serialize(headerReader);
+	}
+
+	const FString mismatch = header.Validate(ExpectedHeader);
+	if (!mismatch.IsEmpty())
+	{
+		UE_LOG(DoNNavigationLog, Warning, TEXT("Baked navigation grid %s is out of date (%s) and will be ignored. Please re-bake."), *Filename, *mismatch);
+		Unload();
+		return false;
+	}
+
+	Bits = data + FDonBakedNavigationGridHeader::SerializedSize;
+	XGridSize = header.XGridSize;
+	XYGridSize = (int64)header.XGridSize * header.YGridSize;
+
+	return true;
+}
+
+void FDonBakedNavigationGrid::Unload()
+{
+	Bits = nullptr;
+
+	// Regions must be released before the file they map
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	FileData.Empty();
+}
+
+bool FDonBakedNavigationGrid::Save(const FString& Filename, const FDonBakedNavigationGridHeader& Header, const TArray<uint8>& BlockedVoxels)
+{
+	if (!ensure(BlockedVoxels.Num() == Header.NumVoxels()))
+		return false;
+
+	TArray<uint8> fileData;
+	{
+		FMemoryWriter headerWriter(fileData);
+		FDonBakedNavigationGridHeader header = Header;
+		header.Serialize(headerWriter);
+	}
+
+	if (!ensure(fileData.Num() == FDonBakedNavigationGridHeader::SerializedSize))
+		return false;
+
+	fileData.SetNumZeroed(Header.GetFileSize());
+
+	uint8* bits = fileData.GetData() + FDonBakedNavigationGridHeader::SerializedSize;
+
+	for (int32 i = 0; i < BlockedVoxels.Num(); i++)
+	{
+		if (BlockedVoxels[i])
+			bits[i >> 3] |= 1 << (i & 7);
+	}
+
+	return FFileHelper::SaveArrayToFile(fileData, *Filename);
+}
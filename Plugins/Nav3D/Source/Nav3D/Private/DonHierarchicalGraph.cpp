@@ -0,0 +1,513 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "DonHierarchicalGraph.h"
+#include "DonAINavigationPrivatePCH.h"
+#include "DonNavigationCommon.h"
+
+void FDonHierarchicalGraph::Reset()
+{
+	Nodes.Empty();
+	Clusters.Empty();
+	GridSize = FIntVector::ZeroValue;
+	NumClusters = FIntVector::ZeroValue;
+	DirtyClusters.Empty();
+	DirtyFaces.Empty();
+	DerivedClusters.Empty();
+	DerivedFaces.Empty();
+}
+
+void FDonHierarchicalGraph::Initialize(const FIntVector& GridSizeIn, int32 ClusterSizeIn)
+{
+	Reset();
+
+	GridSize = GridSizeIn;
+	ClusterSize = FMath::Max(ClusterSizeIn, 2);
+	NumClusters = FIntVector(FMath::DivideAndRoundUp(GridSize.X, ClusterSize), FMath::DivideAndRoundUp(GridSize.Y, ClusterSize), FMath::DivideAndRoundUp(GridSize.Z, ClusterSize));
+
+	if (NumClusters.X <= 0 || NumClusters.Y <= 0 || NumClusters.Z <= 0)
+		return;
+
+	Clusters.SetNum(NumClusters.X * NumClusters.Y * NumClusters.Z);
+
+	DerivedClusters.Init(false, Clusters.Num());
+	DerivedFaces.Init(false, Clusters.Num() * 3);
+}
+
+void FDonHierarchicalGraph::Build(const FIntVector& GridSizeIn, int32 ClusterSizeIn, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	Initialize(GridSizeIn, ClusterSizeIn);
+
+	for (int32 cluster = 0; cluster < Clusters.Num(); cluster++)
+		DeriveCluster(cluster, IsNavigable);
+}
+
+void FDonHierarchicalGraph::DeriveFace(int32 Cluster, int32 Axis, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	if (DerivedFaces[Cluster * 3 + Axis])
+		return;
+
+	BuildEntrances(Cluster, Axis, IsNavigable);
+
+	DerivedFaces[Cluster * 3 + Axis] = true;
+}
+
+void FDonHierarchicalGraph::DeriveCluster(int32 Cluster, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	if (DerivedClusters[Cluster])
+		return;
+
+	// Intra-cluster edges need the entrances on all six faces. (Faces only ever add entrances to clusters that haven't been derived yet, as derived clusters have all of theirs)
+	for (int32 axis = 0; axis < 3; axis++)
+	{
+		DeriveFace(Cluster, axis, IsNavigable);
+
+		const int32 previous = PreviousCluster(Cluster, axis);
+
+		if (previous != INDEX_NONE)
+			DeriveFace(previous, axis, IsNavigable);
+	}
+
+	BuildIntraClusterEdges(Cluster, IsNavigable);
+
+	DerivedClusters[Cluster] = true;
+}
+
+void FDonHierarchicalGraph::MarkDirty(const TArray<FIntVector>& ChangedVoxels)
+{
+	if (!IsValid())
+		return;
+
+	for (FIntVector voxel : ChangedVoxels)
+	{
+		const int32 cluster = ClusterAt(voxel);
+		if (cluster == INDEX_NONE)
+			continue;
+
+		// Anything not derived yet will see the change when it is:
+		auto markCluster = [this](int32 Cluster) { if (DerivedClusters[Cluster]) DirtyClusters.Add(Cluster); };
+		auto markFace = [this](int32 Cluster, int32 Axis) { if (DerivedFaces[Cluster * 3 + Axis]) DirtyFaces.Add(FIntPoint(Cluster, Axis)); };
+
+		markCluster(cluster);
+
+		// Voxels lying on a face also decide the entrances across it, which in turn changes the cluster on the other side:
+		const FIntVector min = ClusterMin(cluster);
+		const FIntVector max = ClusterMax(cluster);
+
+		for (int32 axis = 0; axis < 3; axis++)
+		{
+			const int32 next = NextCluster(cluster, axis);
+
+			if (voxel[axis] == max[axis] - 1 && next != INDEX_NONE)
+			{
+				markFace(cluster, axis);
+				markCluster(next);
+			}
+
+			if (voxel[axis] == min[axis] && voxel[axis] > 0)
+			{
+				FIntVector previousVoxel = voxel;
+				previousVoxel[axis]--;
+
+				const int32 previous = ClusterAt(previousVoxel);
+
+				markFace(previous, axis);
+				markCluster(previous);
+			}
+		}
+	}
+}
+
+void FDonHierarchicalGraph::RebuildDirty(TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	for (const FIntPoint& face : DirtyFaces)
+	{
+		RemoveEntrances(face.X, face.Y);
+		BuildEntrances(face.X, face.Y, IsNavigable);
+	}
+
+	for (int32 cluster : DirtyClusters)
+		BuildIntraClusterEdges(cluster, IsNavigable);
+
+	DirtyFaces.Reset();
+	DirtyClusters.Reset();
+}
+
+int32 FDonHierarchicalGraph::ClusterAt(const FIntVector& Voxel) const
+{
+	if (!IsValid() || (uint32)Voxel.X >= (uint32)GridSize.X || (uint32)Voxel.Y >= (uint32)GridSize.Y || (uint32)Voxel.Z >= (uint32)GridSize.Z)
+		return INDEX_NONE;
+
+	return ClusterIndex(Voxel / ClusterSize);
+}
+
+FIntVector FDonHierarchicalGraph::ClusterMax(int32 Cluster) const
+{
+	const FIntVector min = ClusterMin(Cluster);
+
+	// (clusters along the far edges of the grid may be partial)
+	return FIntVector(FMath::Min(min.X + ClusterSize, GridSize.X), FMath::Min(min.Y + ClusterSize, GridSize.Y), FMath::Min(min.Z + ClusterSize, GridSize.Z));
+}
+
+int32 FDonHierarchicalGraph::NextCluster(int32 Cluster, int32 Axis) const
+{
+	FIntVector clusterCoords = ClusterCoordsOf(Cluster);
+	clusterCoords[Axis]++;
+
+	return clusterCoords[Axis] < NumClusters[Axis] ? ClusterIndex(clusterCoords) : INDEX_NONE;
+}
+
+int32 FDonHierarchicalGraph::PreviousCluster(int32 Cluster, int32 Axis) const
+{
+	FIntVector clusterCoords = ClusterCoordsOf(Cluster);
+	clusterCoords[Axis]--;
+
+	return clusterCoords[Axis] >= 0 ? ClusterIndex(clusterCoords) : INDEX_NONE;
+}
+
+void FDonHierarchicalGraph::BuildEntrances(int32 Cluster, int32 Axis, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	const int32 next = NextCluster(Cluster, Axis);
+	if (next == INDEX_NONE)
+		return;
+
+	const int32 axisU = (Axis + 1) % 3;
+	const int32 axisV = (Axis + 2) % 3;
+
+	const FIntVector min = ClusterMin(Cluster);
+	const FIntVector max = ClusterMax(Cluster);
+	const int32 sizeU = max[axisU] - min[axisU];
+	const int32 sizeV = max[axisV] - min[axisV];
+
+	FIntVector step = FIntVector::ZeroValue;
+	step[Axis] = 1;
+
+	// Voxel (u, v) of the face, on this cluster's side:
+	auto faceVoxel = [&](int32 Cell)
+	{
+		FIntVector voxel;
+		voxel[Axis] = max[Axis] - 1;
+		voxel[axisU] = min[axisU] + Cell % sizeU;
+		voxel[axisV] = min[axisV] + Cell / sizeU;
+
+		return voxel;
+	};
+
+	TArray<bool> isOpen;
+	isOpen.SetNumUninitialized(sizeU * sizeV);
+
+	for (int32 cell = 0; cell < isOpen.Num(); cell++)
+	{
+		const FIntVector voxel = faceVoxel(cell);
+		isOpen[cell] = IsNavigable(voxel) && IsNavigable(voxel + step);
+	}
+
+	// Each 4-connected patch of open cells gets a single pair of entrances, placed at the cell nearest to the patch's centroid:
+	TArray<int32> patch;
+	TArray<int32> stack;
+
+	for (int32 seed = 0; seed < isOpen.Num(); seed++)
+	{
+		if (!isOpen[seed])
+			continue;
+
+		patch.Reset();
+		stack.Add(seed);
+		isOpen[seed] = false;
+
+		while (stack.Num())
+		{
+			const int32 cell = stack.Pop(false);
+			const int32 u = cell % sizeU;
+			const int32 v = cell / sizeU;
+
+			patch.Add(cell);
+
+			const int32 adjacent[4] = { u > 0 ? cell - 1 : INDEX_NONE, u < sizeU - 1 ? cell + 1 : INDEX_NONE, v > 0 ? cell - sizeU : INDEX_NONE, v < sizeV - 1 ? cell + sizeU : INDEX_NONE };
+
+			for (int32 neighbor : adjacent)
+			{
+				if (neighbor != INDEX_NONE && isOpen[neighbor])
+				{
+					isOpen[neighbor] = false;
+					stack.Add(neighbor);
+				}
+			}
+		}
+
+		FVector2D centroid = FVector2D::ZeroVector;
+		for (int32 cell : patch)
+			centroid += FVector2D(cell % sizeU, cell / sizeU);
+
+		centroid /= patch.Num();
+
+		int32 entranceCell = patch[0];
+		float entranceDistance = MAX_flt;
+
+		for (int32 cell : patch)
+		{
+			const float distance = FVector2D::DistSquared(centroid, FVector2D(cell % sizeU, cell / sizeU));
+
+			if (distance < entranceDistance)
+			{
+				entranceCell = cell;
+				entranceDistance = distance;
+			}
+		}
+
+		const FIntVector voxel = faceVoxel(entranceCell);
+
+		const int32 node = Nodes.Add(FDonHierarchicalGraphNode(voxel, Cluster));
+		const int32 partner = Nodes.Add(FDonHierarchicalGraphNode(voxel + step, next));
+
+		Nodes[node].Partner = partner;
+		Nodes[partner].Partner = node;
+
+		Clusters[Cluster].Nodes.Add(node);
+		Clusters[Cluster].FaceNodes[Axis].Add(node);
+		Clusters[next].Nodes.Add(partner);
+	}
+}
+
+void FDonHierarchicalGraph::RemoveEntrances(int32 Cluster, int32 Axis)
+{
+	const int32 next = NextCluster(Cluster, Axis);
+
+	for (int32 node : Clusters[Cluster].FaceNodes[Axis])
+	{
+		const int32 partner = Nodes[node].Partner;
+
+		Clusters[Cluster].Nodes.RemoveSingleSwap(node);
+		Clusters[next].Nodes.RemoveSingleSwap(partner);
+
+		// (edges from other entrances to these are dropped when the clusters on either side are re-derived, see RebuildDirty)
+		Nodes.RemoveAt(node);
+		Nodes.RemoveAt(partner);
+	}
+
+	Clusters[Cluster].FaceNodes[Axis].Reset();
+}
+
+void FDonHierarchicalGraph::BuildIntraClusterEdges(int32 Cluster, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	const auto& clusterNodes = Clusters[Cluster].Nodes;
+
+	for (int32 node : clusterNodes)
+		Nodes[node].Edges.Reset();
+
+	TArray<float> costs;
+
+	// Intra-cluster costs are symmetric, so every entrance only needs to search for the ones after it:
+	for (int32 i = 0; i < clusterNodes.Num() - 1; i++)
+	{
+		SearchCluster(Cluster, Nodes[clusterNodes[i]].Voxel, IsNavigable, costs);
+
+		for (int32 j = i + 1; j < clusterNodes.Num(); j++)
+		{
+			const float cost = costs[LocalIndex(Cluster, Nodes[clusterNodes[j]].Voxel)];
+			if (cost == MAX_flt)
+				continue;
+
+			Nodes[clusterNodes[i]].Edges.Emplace(clusterNodes[j], cost);
+			Nodes[clusterNodes[j]].Edges.Emplace(clusterNodes[i], cost);
+		}
+	}
+}
+
+void FDonHierarchicalGraph::SearchCluster(int32 Cluster, const FIntVector& From, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable, TArray<float>& OutCosts) const
+{
+	static const FIntVector directions[6] = { FIntVector(1, 0, 0), FIntVector(-1, 0, 0), FIntVector(0, 1, 0), FIntVector(0, -1, 0), FIntVector(0, 0, 1), FIntVector(0, 0, -1) };
+	static const float diagonalCost = 1.41421356f;
+
+	const FIntVector min = ClusterMin(Cluster);
+	const FIntVector max = ClusterMax(Cluster);
+	const int32 numVoxels = ClusterSize * ClusterSize * ClusterSize;
+
+	auto isOpen = [&](const FIntVector& Voxel)
+	{
+		return Voxel.X >= min.X && Voxel.Y >= min.Y && Voxel.Z >= min.Z && Voxel.X < max.X && Voxel.Y < max.Y && Voxel.Z < max.Z && IsNavigable(Voxel);
+	};
+
+	OutCosts.Init(MAX_flt, numVoxels);
+	TBitArray<> closed(false, numVoxels);
+
+	// The frontier has no decrease-key, so voxels may be queued several times. Only the cheapest entry is expanded:
+	DoNNavigation::PriorityQueue<int32, float> frontier;
+
+	OutCosts[LocalIndex(Cluster, From)] = 0.f;
+	frontier.put(LocalIndex(Cluster, From), 0.f);
+
+	auto relax = [&](const FIntVector& Voxel, float Cost)
+	{
+		const int32 local = LocalIndex(Cluster, Voxel);
+
+		if (Cost < OutCosts[local])
+		{
+			OutCosts[local] = Cost;
+			frontier.put(local, Cost);
+		}
+	};
+
+	while (!frontier.empty())
+	{
+		const int32 current = frontier.get();
+		if (closed[current])
+			continue;
+
+		closed[current] = true;
+
+		const FIntVector voxel = min + FIntVector(current % ClusterSize, (current / ClusterSize) % ClusterSize, current / (ClusterSize * ClusterSize));
+		const float cost = OutCosts[current];
+
+		bool bIsOpen[6];
+
+		for (int32 i = 0; i < 6; i++)
+		{
+			bIsOpen[i] = isOpen(voxel + directions[i]);
+
+			if (bIsOpen[i])
+				relax(voxel + directions[i], cost + 1.f);
+		}
+
+		// Implicit neighbors: any two direct neighbors along different axes
+		for (int32 i = 0; i < 6; i++)
+		{
+			for (int32 j = i + 2 - (i & 1); j < 6; j++)
+			{
+				const FIntVector diagonal = voxel + directions[i] + directions[j];
+
+				if (bIsOpen[i] && bIsOpen[j] && isOpen(diagonal))
+					relax(diagonal, cost + diagonalCost);
+			}
+		}
+	}
+}
+
+bool FDonHierarchicalGraph::FindCorridor(const FIntVector& Origin, const FIntVector& Destination, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable, TSet<int32>& OutCorridor)
+{
+	OutCorridor.Reset();
+
+	const int32 originCluster = ClusterAt(Origin);
+	const int32 destinationCluster = ClusterAt(Destination);
+
+	if (originCluster == INDEX_NONE || destinationCluster == INDEX_NONE)
+		return false;
+
+	DeriveCluster(originCluster, IsNavigable);
+	DeriveCluster(destinationCluster, IsNavigable);
+
+	// Connect both endpoints to the entrances of their own cluster. (Intra-cluster costs are symmetric, so the destination's search doubles as the cost to go)
+	TArray<float> originCosts, destinationCosts;
+	SearchCluster(originCluster, Origin, IsNavigable, originCosts);
+	SearchCluster(destinationCluster, Destination, IsNavigable, destinationCosts);
+
+	// A route that never leaves the origin's cluster has no entrance on it (bestNode stays INDEX_NONE)
+	float bestCost = originCluster == destinationCluster ? originCosts[LocalIndex(originCluster, Destination)] : MAX_flt;
+	int32 bestNode = INDEX_NONE;
+
+	TArray<float> costs;
+	TArray<int32> parents;
+	TBitArray<> closed;
+
+	// Deriving clusters along the way adds entrances:
+	auto growToFitNodes = [&]()
+	{
+		const int32 numNew = Nodes.GetMaxIndex() - costs.Num();
+
+		if (numNew <= 0)
+			return;
+
+		for (int32 i = 0; i < numNew; i++)
+		{
+			costs.Add(MAX_flt);
+			parents.Add(INDEX_NONE);
+		}
+
+		closed.Add(false, numNew);
+	};
+
+	growToFitNodes();
+
+	DoNNavigation::PriorityQueue<int32, float> frontier;
+
+	auto heuristic = [&](int32 Node) { return FVector::Dist(FVector(Nodes[Node].Voxel), FVector(Destination)); };
+
+	auto relax = [&](int32 Node, int32 Parent, float Cost)
+	{
+		if (Cost < costs[Node])
+		{
+			costs[Node] = Cost;
+			parents[Node] = Parent;
+			frontier.put(Node, Cost + heuristic(Node));
+		}
+	};
+
+	for (int32 node : Clusters[originCluster].Nodes)
+	{
+		const float cost = originCosts[LocalIndex(originCluster, Nodes[node].Voxel)];
+
+		if (cost != MAX_flt)
+			relax(node, INDEX_NONE, cost);
+	}
+
+	while (!frontier.empty())
+	{
+		const int32 current = frontier.get();
+		if (closed[current])
+			continue;
+
+		// Nothing left in the frontier can beat the best route found so far:
+		if (costs[current] + heuristic(current) >= bestCost)
+			break;
+
+		closed[current] = true;
+
+		// (entrances are reached through their partners, whose clusters may not have been derived yet)
+		DeriveCluster(Nodes[current].Cluster, IsNavigable);
+		growToFitNodes();
+
+		const auto& node = Nodes[current];
+
+		if (node.Cluster == destinationCluster)
+		{
+			const float costToGo = destinationCosts[LocalIndex(destinationCluster, node.Voxel)];
+
+			if (costToGo != MAX_flt && costs[current] + costToGo < bestCost)
+			{
+				bestCost = costs[current] + costToGo;
+				bestNode = current;
+			}
+		}
+
+		if (!closed[node.Partner])
+			relax(node.Partner, current, costs[current] + 1.f);
+
+		for (const auto& edge : node.Edges)
+		{
+			if (!closed[edge.Target])
+				relax(edge.Target, current, costs[current] + edge.Cost);
+		}
+	}
+
+	if (bestCost == MAX_flt)
+		return false;
+
+	OutCorridor.Add(originCluster);
+	OutCorridor.Add(destinationCluster);
+
+	for (int32 node = bestNode; node != INDEX_NONE; node = parents[node])
+		OutCorridor.Add(Nodes[node].Cluster);
+
+	return true;
+}
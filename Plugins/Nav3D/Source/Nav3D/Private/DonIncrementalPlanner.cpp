@@ -0,0 +1,329 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "DonIncrementalPlanner.h"
+#include "DonAINavigationPrivatePCH.h"
+
+void FDonIncrementalPlanner::Reset(const FIntVector& StartIn, const FIntVector& GoalIn)
+{
+	States.Reset();
+	Queue.Reset();
+
+	{
+		FScopeLock lock(&PendingChangesLock);
+		PendingChanges.Reset();
+	}
+
+	Start = StartIn;
+	Goal = GoalIn;
+	KeyModifier = 0.f;
+	NumProbes = 0;
+	bIsValid = true;
+
+	const FKey goalKey(Heuristic(Start, Goal), 0.f);
+
+	FState& goalState = States.Add(Goal);
+	goalState.Rhs = 0.f;
+	goalState.QueuedKey = goalKey;
+	goalState.bIsQueued = true;
+
+	Queue.HeapPush(FQueueEntry(goalKey, Goal));
+}
+
+void FDonIncrementalPlanner::Discard()
+{
+	States.Empty();
+	Queue.Empty();
+	ProbeCache.Empty();
+
+	{
+		FScopeLock lock(&PendingChangesLock);
+		PendingChanges.Empty();
+	}
+
+	bIsValid = false;
+}
+
+void FDonIncrementalPlanner::MoveStart(const FIntVector& NewStart)
+{
+	if (NewStart == Start)
+		return;
+
+	// Rather than re-keying the whole queue, raise the bar for everything queued from here on by as much as the heuristic may have dropped:
+	KeyModifier += Heuristic(Start, NewStart);
+	Start = NewStart;
+}
+
+void FDonIncrementalPlanner::NotifyVoxelChanged(const FIntVector& Voxel)
+{
+	FScopeLock lock(&PendingChangesLock);
+
+	PendingChanges.Add(Voxel);
+}
+
+bool FDonIncrementalPlanner::Step(TFunctionRef<bool(const FIntVector& Voxel)> IsNavigableUncached)
+{
+	ProbeCache.Reset();
+
+	auto IsNavigable = [this, &IsNavigableUncached](const FIntVector& Voxel)
+	{
+		if (const bool* bIsNavigable = ProbeCache.Find(Voxel))
+			return *bIsNavigable;
+
+		NumProbes++;
+
+		return ProbeCache.Add(Voxel, IsNavigableUncached(Voxel));
+	};
+
+	ApplyPendingChanges(IsNavigable);
+	PruneQueue();
+
+	if (!Queue.Num())
+		return true;
+
+	// Done once nothing queued could still improve the start and the start itself is settled:
+	if (!(Queue.HeapTop().Key < CalculateKey(Start)) && GetRhs(Start) <= GetG(Start))
+		return true;
+
+	FQueueEntry entry(FKey(), FIntVector::ZeroValue);
+	Queue.HeapPop(entry);
+
+	const FIntVector voxel = entry.Voxel;
+	const FKey newKey = CalculateKey(voxel);
+
+	// Note:- UpdateVertex may add states, so never hold on to a state across calls to it
+	FState& state = States.FindChecked(voxel);
+
+	// Queued before the start moved? Requeue with an up to date key:
+	if (entry.Key < newKey)
+	{
+		state.QueuedKey = newKey;
+		Queue.HeapPush(FQueueEntry(newKey, voxel));
+
+		return false;
+	}
+
+	state.bIsQueued = false;
+
+	TArray<FIntVector, TInlineAllocator<18>> neighbors;
+	GetNeighbors(voxel, neighbors);
+
+	if (state.G > state.Rhs)
+	{
+		// Overconsistent: settle the voxel and let its neighbors route through it
+		state.G = state.Rhs;
+
+		for (const FIntVector& neighbor : neighbors)
+			UpdateVertex(neighbor, IsNavigable);
+	}
+	else
+	{
+		// Underconsistent (a route through here was cut off): invalidate and let the voxel and its neighbors find other routes
+		state.G = MAX_flt;
+
+		UpdateVertex(voxel, IsNavigable);
+
+		for (const FIntVector& neighbor : neighbors)
+			UpdateVertex(neighbor, IsNavigable);
+	}
+
+	return false;
+}
+
+bool FDonIncrementalPlanner::HasPath() const
+{
+	return bIsValid && GetRhs(Start) != MAX_flt;
+}
+
+bool FDonIncrementalPlanner::ExtractPath(TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable, TArray<FIntVector>& OutPath) const
+{
+	OutPath.Reset();
+
+	if (!HasPath())
+		return false;
+
+	TArray<FIntVector, TInlineAllocator<18>> neighbors;
+	FIntVector current = Start;
+	OutPath.Add(current);
+
+	// Descend the cost-to-goal gradient. (A path can't be longer than the number of states, anything longer means we're going in circles)
+	while (current != Goal)
+	{
+		if (OutPath.Num() > States.Num())
+			return false;
+
+		GetNeighbors(current, neighbors);
+
+		float bestCost = MAX_flt;
+		const FIntVector* best = nullptr;
+
+		for (const FIntVector& neighbor : neighbors)
+		{
+			const float g = GetG(neighbor);
+			if (g == MAX_flt)
+				continue;
+
+			const float cost = EdgeCost(current, neighbor, IsNavigable);
+			if (cost == MAX_flt)
+				continue;
+
+			if (cost + g < bestCost)
+			{
+				bestCost = cost + g;
+				best = &neighbor;
+			}
+		}
+
+		if (!best)
+			return false;
+
+		current = *best;
+		OutPath.Add(current);
+	}
+
+	return true;
+}
+
+float FDonIncrementalPlanner::Heuristic(const FIntVector& A, const FIntVector& B)
+{
+	return FVector::Dist(FVector(A), FVector(B));
+}
+
+float FDonIncrementalPlanner::EdgeCost(const FIntVector& From, const FIntVector& To, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	static const float diagonalCost = 1.41421356f;
+
+	if (!IsNavigable(From) || !IsNavigable(To))
+		return MAX_flt;
+
+	const FIntVector delta = To - From;
+
+	if (FMath::Abs(delta.X) + FMath::Abs(delta.Y) + FMath::Abs(delta.Z) == 1)
+		return 1.f;
+
+	// Diagonal: both direct neighbors it passes between must be open
+	const FIntVector stepA = delta.X != 0 ? FIntVector(delta.X, 0, 0) : FIntVector(0, delta.Y, 0);
+	const FIntVector stepB = delta - stepA;
+
+	return IsNavigable(From + stepA) && IsNavigable(From + stepB) ? diagonalCost : MAX_flt;
+}
+
+void FDonIncrementalPlanner::GetNeighbors(const FIntVector& Voxel, TArray<FIntVector, TInlineAllocator<18>>& OutNeighbors)
+{
+	OutNeighbors.Reset();
+
+	for (int32 z = -1; z <= 1; z++)
+		for (int32 y = -1; y <= 1; y++)
+			for (int32 x = -1; x <= 1; x++)
+			{
+				const int32 manhattan = FMath::Abs(x) + FMath::Abs(y) + FMath::Abs(z);
+
+				if (manhattan == 1 || manhattan == 2)
+					OutNeighbors.Add(Voxel + FIntVector(x, y, z));
+			}
+}
+
+FDonIncrementalPlanner::FKey FDonIncrementalPlanner::CalculateKey(const FIntVector& Voxel) const
+{
+	const float cost = FMath::Min(GetG(Voxel), GetRhs(Voxel));
+
+	if (cost == MAX_flt)
+		return FKey();
+
+	return FKey(cost + Heuristic(Start, Voxel) + KeyModifier, cost);
+}
+
+void FDonIncrementalPlanner::UpdateVertex(const FIntVector& Voxel, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	float rhs = 0.f;
+
+	if (Voxel != Goal)
+	{
+		rhs = MAX_flt;
+
+		TArray<FIntVector, TInlineAllocator<18>> neighbors;
+		GetNeighbors(Voxel, neighbors);
+
+		for (const FIntVector& neighbor : neighbors)
+		{
+			const float g = GetG(neighbor);
+			if (g == MAX_flt)
+				continue;
+
+			const float cost = EdgeCost(Voxel, neighbor, IsNavigable);
+			if (cost != MAX_flt)
+				rhs = FMath::Min(rhs, cost + g);
+		}
+	}
+
+	FState& state = States.FindOrAdd(Voxel);
+	state.Rhs = rhs;
+
+	if (state.G != state.Rhs)
+	{
+		state.QueuedKey = CalculateKey(Voxel);
+		state.bIsQueued = true;
+
+		Queue.HeapPush(FQueueEntry(state.QueuedKey, Voxel));
+	}
+	else
+		state.bIsQueued = false;
+}
+
+void FDonIncrementalPlanner::ApplyPendingChanges(TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	TSet<FIntVector> changes;
+
+	{
+		FScopeLock lock(&PendingChangesLock);
+
+		if (!PendingChanges.Num())
+			return;
+
+		changes = MoveTemp(PendingChanges);
+		PendingChanges.Reset();
+	}
+
+	// A changed voxel affects its own edges and the diagonals passing beside it, all of which end in its neighbors.
+	// Voxels the search never touched have no route to the goal either way, so they can be left alone.
+	TArray<FIntVector, TInlineAllocator<18>> neighbors;
+
+	for (const FIntVector& voxel : changes)
+	{
+		if (States.Contains(voxel))
+			UpdateVertex(voxel, IsNavigable);
+
+		GetNeighbors(voxel, neighbors);
+
+		for (const FIntVector& neighbor : neighbors)
+		{
+			if (States.Contains(neighbor))
+				UpdateVertex(neighbor, IsNavigable);
+		}
+	}
+}
+
+void FDonIncrementalPlanner::PruneQueue()
+{
+	while (Queue.Num())
+	{
+		const FQueueEntry& top = Queue.HeapTop();
+		const FState* state = States.Find(top.Voxel);
+
+		if (state && state->bIsQueued && state->QueuedKey == top.Key)
+			return;
+
+		Queue.HeapPopDiscard();
+	}
+}
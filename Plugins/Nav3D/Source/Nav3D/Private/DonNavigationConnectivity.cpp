@@ -0,0 +1,200 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "DonNavigationConnectivity.h"
+#include "DonAINavigationPrivatePCH.h"
+
+namespace
+{
+	// 6 direct and 12 implicit neighbors
+	struct FConnectivityOffsets
+	{
+		FIntVector Offsets[18];
+
+		FConnectivityOffsets()
+		{
+			int32 numOffsets = 0;
+
+			for (int32 z = -1; z <= 1; z++)
+				for (int32 y = -1; y <= 1; y++)
+					for (int32 x = -1; x <= 1; x++)
+					{
+						const int32 manhattan = FMath::Abs(x) + FMath::Abs(y) + FMath::Abs(z);
+
+						if (manhattan == 1 || manhattan == 2)
+							Offsets[numOffsets++] = FIntVector(x, y, z);
+					}
+		}
+	};
+
+	static const FConnectivityOffsets ConnectivityOffsets;
+}
+
+void FDonNavigationConnectivity::Reset()
+{
+	Labels.Empty();
+	Parents.Empty();
+	GridSize = FIntVector::ZeroValue;
+}
+
+void FDonNavigationConnectivity::Build(const FIntVector& GridSizeIn, TFunctionRef<bool(const FIntVector& Voxel)> IsNavigable)
+{
+	Reset();
+
+	GridSize = GridSizeIn;
+
+	if (GridSize.X <= 0 || GridSize.Y <= 0 || GridSize.Z <= 0)
+		return;
+
+	const int32 numVoxels = GridSize.X * GridSize.Y * GridSize.Z;
+
+	Labels.Init(INDEX_NONE, numVoxels);
+
+	// Every voxel is tested exactly once, whether it turns out to be navigable or not:
+	TBitArray<> isTested(false, numVoxels);
+	TArray<int32> stack;
+
+	for (int32 seed = 0; seed < numVoxels; seed++)
+	{
+		if (isTested[seed])
+			continue;
+
+		isTested[seed] = true;
+
+		if (!IsNavigable(VoxelAt(seed)))
+			continue;
+
+		const int32 label = Parents.Add(Parents.Num());
+
+		Labels[seed] = label;
+		stack.Add(seed);
+
+		while (stack.Num())
+		{
+			const FIntVector voxel = VoxelAt(stack.Pop(false));
+
+			for (const FIntVector& offset : ConnectivityOffsets.Offsets)
+			{
+				const FIntVector neighbor = voxel + offset;
+				if (!IsInsideGrid(neighbor))
+					continue;
+
+				const int32 neighborIndex = LinearIndex(neighbor);
+				if (isTested[neighborIndex])
+					continue;
+
+				isTested[neighborIndex] = true;
+
+				if (IsNavigable(neighbor))
+				{
+					Labels[neighborIndex] = label;
+					stack.Add(neighborIndex);
+				}
+			}
+		}
+	}
+
+	Parents.Shrink();
+}
+
+void FDonNavigationConnectivity::MarkNavigable(const FIntVector& Voxel)
+{
+	if (!IsValid() || !IsInsideGrid(Voxel))
+		return;
+
+	const int32 index = LinearIndex(Voxel);
+	if (Labels[index] != INDEX_NONE)
+		return;
+
+	int32 root = INDEX_NONE;
+
+	for (const FIntVector& offset : ConnectivityOffsets.Offsets)
+	{
+		const FIntVector neighbor = Voxel + offset;
+		if (!IsInsideGrid(neighbor))
+			continue;
+
+		const int32 neighborLabel = Labels[LinearIndex(neighbor)];
+		if (neighborLabel == INDEX_NONE)
+			continue;
+
+		const int32 neighborRoot = FindRootAndCompress(neighborLabel);
+
+		if (root == INDEX_NONE)
+			root = neighborRoot;
+		else if (neighborRoot != root)
+			Parents[neighborRoot] = root;
+	}
+
+	// An isolated pocket starts a component of its own:
+	if (root == INDEX_NONE)
+		root = Parents.Add(Parents.Num());
+
+	Labels[index] = root;
+}
+
+void FDonNavigationConnectivity::MarkBlocked(const FIntVector& Voxel)
+{
+	if (!IsValid() || !IsInsideGrid(Voxel))
+		return;
+
+	Labels[LinearIndex(Voxel)] = INDEX_NONE;
+}
+
+bool FDonNavigationConnectivity::MayBeConnected(const FIntVector& A, const FIntVector& B) const
+{
+	if (!IsValid() || !IsInsideGrid(A) || !IsInsideGrid(B))
+		return true;
+
+	const int32 labelA = Labels[LinearIndex(A)];
+	const int32 labelB = Labels[LinearIndex(B)];
+
+	if (labelA == INDEX_NONE || labelB == INDEX_NONE)
+		return true;
+
+	return FindRoot(labelA) == FindRoot(labelB);
+}
+
+int32 FDonNavigationConnectivity::NumComponents() const
+{
+	int32 numComponents = 0;
+
+	for (int32 label = 0; label < Parents.Num(); label++)
+	{
+		if (Parents[label] == label)
+			numComponents++;
+	}
+
+	return numComponents;
+}
+
+int32 FDonNavigationConnectivity::FindRoot(int32 Label) const
+{
+	while (Parents[Label] != Label)
+		Label = Parents[Label];
+
+	return Label;
+}
+
+int32 FDonNavigationConnectivity::FindRootAndCompress(int32 Label)
+{
+	// Path halving: every other label on the way up is linked to its grandparent
+	while (Parents[Label] != Label)
+	{
+		Parents[Label] = Parents[Parents[Label]];
+		Label = Parents[Label];
+	}
+
+	return Label;
+}
@@ -15,6 +15,10 @@
 #include "DonNavigationManager.h"
 #include "DonAINavigationPrivatePCH.h"
 #include "Multithreading/DonNavigationWorker.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopedSlowTask.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/PhysicsAsset.h"
 
 #include <stdio.h>
 #include <limits>
@@ -27,13 +31,153 @@ DECLARE_CYCLE_STAT(TEXT("DonNavigation ~ DynamicCollisionSampling"), STAT_Dynami
 #define OPTIMIZE_SEGMENT 1
 #define USE_26_DOFs 1
 
-void FDonNavigationVoxel::BroadcastCollisionUpdates()
+// Voxel grid (bricks & paging)
+
+void FDonNavVoxelGrid::Init(int32 InXSize, int32 InYSize, int32 InZSize)
 {
-	// Protect ourselves from delegate owners reallocating the TArray while we're iterating:
-	auto notifyees_safecopy = DynamicCollisionNotifyees; 
+	ClearAll();
 
-	for (const auto& notifyee : notifyees_safecopy)
-		notifyee.Listener.ExecuteIfBound(notifyee.Payload);
+	XSize = FMath::Max(InXSize, 0);
+	YSize = FMath::Max(InYSize, 0);
+	ZSize = FMath::Max(InZSize, 0);
+
+	XBricks = FMath::DivideAndRoundUp(XSize, BrickMask + 1);
+	XYBricks = XBricks * FMath::DivideAndRoundUp(YSize, BrickMask + 1);
+	NumBricks = XYBricks * FMath::DivideAndRoundUp(ZSize, BrickMask + 1);
+
+	if (!NumBricks)
+		return;
+
+	const SIZE_T commitAlignment = FPlatformMemory::FPlatformVirtualMemoryBlock::GetCommitAlignment();
+	const int32 voxelsPerCommit = (int32)FMath::DivideAndRoundUp<SIZE_T>(commitAlignment, sizeof(FDonNavigationVoxel));
+	const int32 voxelsPerPage = FMath::RoundUpToPowerOfTwo(FMath::Max(1 << VoxelsPerBrickShift, voxelsPerCommit));
+
+	VoxelsPerPageShift = FMath::FloorLog2(voxelsPerPage);
+	BytesPerPage = Align((SIZE_T)voxelsPerPage * sizeof(FDonNavigationVoxel), commitAlignment);
+	NumPages = FMath::DivideAndRoundUp(NumBricks, 1 << (VoxelsPerPageShift - VoxelsPerBrickShift));
+
+	// Reserve address space only, pages are committed lazily by TouchPage:
+	VirtualMemory = FPlatformMemory::FPlatformVirtualMemoryBlock::AllocateVirtual(GetReservedSize());
+	Voxels = (FDonNavigationVoxel*)VirtualMemory.GetVirtualPointer();
+
+	PageStates.SetNumZeroed(NumPages);
+	PagePins.SetNumZeroed(NumPages);
+}
+
+void FDonNavVoxelGrid::ClearAll()
+{
+	if (Voxels)
+		VirtualMemory.FreeVirtual();
+
+	Voxels = nullptr;
+	PageStates.Empty();
+	PagePins.Empty();
+	ResidentPageCount = EvictionClockHand = 0;
+	RingOffset = FIntVector::ZeroValue;
+	XSize = YSize = ZSize = 0;
+	XBricks = XYBricks = NumBricks = NumPages = 0;
+}
+
+void FDonNavVoxelGrid::TouchPage(int32 Page)
+{
+	if (PageStates[Page] == EPageState::Uncommitted)
+	{
+		// Slow path: the worker thread and the game thread may both race to commit the same page
+		FScopeLock lock(&CommitLock);
+
+		if (PageStates[Page] == EPageState::Uncommitted)
+		{
+			VirtualMemory.Commit(Page * BytesPerPage, BytesPerPage);
+
+			// Freshly committed (or recommitted) memory reads as default voxels, i.e. free and not yet sampled
+			FMemory::Memzero((uint8*)Voxels + Page * BytesPerPage, BytesPerPage);
+
+			ResidentPageCount++;
+
+			FPlatformMisc::MemoryBarrier();
+			PageStates[Page] = EPageState::Referenced;
+		}
+
+		return;
+	}
+
+	PageStates[Page] = EPageState::Referenced;
+}
+
+void FDonNavVoxelGrid::Scroll(const FIntVector& Shift)
+{
+	if (!NumBricks)
+		return;
+
+	RingOffset.X = ((RingOffset.X + Shift.X) % XSize + XSize) % XSize;
+	RingOffset.Y = ((RingOffset.Y + Shift.Y) % YSize + YSize) % YSize;
+	RingOffset.Z = ((RingOffset.Z + Shift.Z) % ZSize + ZSize) % ZSize;
+}
+
+void FDonNavVoxelGrid::ResetRegion(const FIntVector& Min, const FIntVector& Max)
+{
+	for (int32 z = FMath::Max(Min.Z, 0); z < FMath::Min(Max.Z, ZSize); z++)
+	{
+		for (int32 y = FMath::Max(Min.Y, 0); y < FMath::Min(Max.Y, YSize); y++)
+		{
+			for (int32 x = FMath::Max(Min.X, 0); x < FMath::Min(Max.X, XSize); x++)
+			{
+				const int32 index = IndexAt(x, y, z);
+
+				// Don't commit pages just to reset them:
+				if (PageStates[PageOf(index)] != EPageState::Uncommitted)
+					Voxels[index] = FDonNavigationVoxel();
+			}
+		}
+	}
+}
+
+void FDonNavVoxelGrid::Pin(const FDonNavigationVoxel* Voxel)
+{
+	FPlatformAtomics::InterlockedIncrement(&PagePins[PageOf(IndexOf(Voxel))]);
+}
+
+void FDonNavVoxelGrid::Unpin(const FDonNavigationVoxel* Voxel)
+{
+	int32& pins = PagePins[PageOf(IndexOf(Voxel))];
+
+	if (FPlatformAtomics::InterlockedDecrement(&pins) < 0)
+		FPlatformAtomics::InterlockedIncrement(&pins);
+}
+
+int32 FDonNavVoxelGrid::EvictColdPages(int32 MaxResidentPages, TFunctionRef<bool(int32 Page)> IsPageInUse)
+{
+	FScopeLock lock(&CommitLock);
+
+	int32 numEvicted = 0;
+
+	// Two full revolutions of the clock are enough to demote every referenced page and then evict it
+	for (int32 i = 0; i < 2 * NumPages && ResidentPageCount > MaxResidentPages; i++)
+	{
+		const int32 page = EvictionClockHand;
+		EvictionClockHand = (EvictionClockHand + 1) % NumPages;
+
+		switch (PageStates[page])
+		{
+		case EPageState::Referenced:
+			PageStates[page] = EPageState::Resident;
+			break;
+		case EPageState::Resident:
+			if (PagePins[page] > 0 || IsPageInUse(page))
+				break;
+
+			PageStates[page] = EPageState::Uncommitted;
+			VirtualMemory.Decommit(page * BytesPerPage, BytesPerPage);
+
+			ResidentPageCount--;
+			numEvicted++;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return numEvicted;
 }
 
 ADonNavigationManager::ADonNavigationManager(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -142,6 +286,223 @@ void ADonNavigationManager::Tick(float DeltaSeconds)
 		ReceiveAsyncDynamicCollisionUpdates();
 		DrawAsyncDebugRequests();	
 	}
+
+	if (CoalescedCollisionUpdates.Num() && !bVoxelGridScrollPending)
+		FlushCoalescedCollisionUpdates();
+
+	if (MaxResidentVoxelBricks > 0 && !bIsUnbound)
+		EvictColdVoxelBricks();
+
+	if (UnboundObstacleBounds.Num())
+		ForgetRemovedUnboundObstacles();
+}
+
+void ADonNavigationManager::ForgetRemovedUnboundObstacles()
+{
+	for (auto it = UnboundObstacleBounds.CreateIterator(); it; ++it)
+	{
+		auto mesh = it.Key().Get();
+		if (mesh && mesh->IsRegistered())
+			continue;
+
+		// Whatever it was occupying is free now:
+		InvalidateNavigationRegion(it.Value());
+		it.RemoveCurrent();
+	}
+}
+
+bool ADonNavigationManager::HasPendingWork_WorkerThread()
+{
+	return ActiveNavigationTasks.Num() || ActiveDynamicCollisionTasks.Num() || !NewNavigationTasks.IsEmpty() || !NewDynamicCollisionTasks.IsEmpty();
+}
+
+void ADonNavigationManager::EvictColdVoxelBricks()
+{
+	const int32 maxResidentPages = FMath::Max(1, MaxResidentVoxelBricks / NAVVolumeData.BricksPerPage());
+
+	if (NAVVolumeData.NumResidentPages() <= maxResidentPages)
+		return;
+
+	// Tasks hold raw voxel pointers, so bricks may only be evicted while the solver is idle. The worker thread holds this lock whenever it has work.
+	if (!NAVVolumeDataLock.TryLock())
+		return;
+
+	if (IsSolverIdle())
+	{
+		// Bricks along active paths must stay resident to deliver dynamic collision updates:
+		TSet<int32> listenedPages;
+		{
+			FScopeLock lock(&VoxelCollisionNotifyeesLock);
+
+			for (const auto& notifyees : VoxelCollisionNotifyees)
+				listenedPages.Add(NAVVolumeData.PageOf(notifyees.Key));
+		}
+
+		const int32 numEvicted = NAVVolumeData.EvictColdPages(maxResidentPages, [&listenedPages](int32 Page) { return listenedPages.Contains(Page); });
+
+		// Cached neighbor lists may point into evicted bricks
+		if (numEvicted)
+			NavGraphCache.Empty();
+
+		UE_LOG(DoNNavigationLog, Verbose, TEXT("Evicted %d voxel pages, %.2f MB remain committed"), numEvicted, NAVVolumeData.GetCommittedSize() / (1024.0 * 1024.0));
+	}
+
+	NAVVolumeDataLock.Unlock();
+}
+
+void ADonNavigationManager::ReleaseHeldPathfindingQueries()
+{
+	bVoxelGridScrollPending = false;
+
+	const TArray<FDonHeldPathfindingQuery> heldQueries = MoveTemp(HeldPathfindingQueries);
+	HeldPathfindingQueries.Reset();
+
+	for (const auto& query : heldQueries)
+	{
+		AActor* actor = query.Actor.Get();
+		if (!actor || SchedulePathfindingTask(actor, query.Destination, query.QueryParams, query.DebugParams, query.ResultHandler, query.DynamicCollisionListener))
+			continue;
+
+		// The caller was told the query was scheduled, so it learns otherwise through its result handler:
+		FDoNNavigationQueryData data(actor, Cast<UPrimitiveComponent>(actor->GetRootComponent()), actor->GetActorLocation(), query.Destination, query.QueryParams, query.DebugParams, NULL, NULL, actor->GetActorLocation(), query.Destination, FDonVoxelCollisionProfile());
+		data.QueryStatus = EDonNavigationQueryStatus::Failure;
+
+		query.ResultHandler.ExecuteIfBound(data);
+	}
+}
+
+bool ADonNavigationManager::IsSolverIdle()
+{
+	return !HasPendingWork_WorkerThread() && CompletedNavigationTasks.IsEmpty() && CompletedCollisionTasks.IsEmpty() && DynamicCollisionBroadcastQueue.IsEmpty();
+}
+
+bool ADonNavigationManager::ScrollVoxelGrid(const FIntVector& Shift, bool bResampleImmediately)
+{
+	if (Shift == FIntVector::ZeroValue)
+	{
+		ReleaseHeldPathfindingQueries();
+		return true;
+	}
+
+	// Same rules as brick eviction, see EvictColdVoxelBricks. Unlike eviction the scroll can't be skipped, so new work is held back until the solver drains.
+	if (!NAVVolumeDataLock.TryLock())
+	{
+		bVoxelGridScrollPending = true;
+		return false;
+	}
+
+	if (!IsSolverIdle())
+	{
+		NAVVolumeDataLock.Unlock();
+
+		bVoxelGridScrollPending = true;
+		return false;
+	}
+
+	const FIntVector gridSize(NAVVolumeData.XSize, NAVVolumeData.YSize, NAVVolumeData.ZSize);
+
+	NAVVolumeData.Scroll(Shift);
+	SetActorLocation(GetActorLocation() + VoxelSize * FVector(Shift));
+
+	// The slabs scrolling into view (in the new logical coordinates) are backed by the storage that just scrolled out of view:
+	TArray<TPair<FIntVector, FIntVector>, TInlineAllocator<3>> scrolledSlabs;
+
+	for (int32 axis = 0; axis < 3; axis++)
+	{
+		const int32 depth = FMath::Min(FMath::Abs(Shift[axis]), gridSize[axis]);
+
+		if (!depth)
+			continue;
+
+		FIntVector slabMin = FIntVector::ZeroValue;
+		FIntVector slabMax = gridSize;
+
+		if (Shift[axis] > 0)
+			slabMin[axis] = gridSize[axis] - depth;
+		else
+			slabMax[axis] = depth;
+
+		scrolledSlabs.Emplace(slabMin, slabMax);
+	}
+
+	auto isScrolledIn = [&scrolledSlabs](const FIntVector& Coords)
+	{
+		for (const auto& slab : scrolledSlabs)
+		{
+			if (Coords.X >= slab.Key.X && Coords.Y >= slab.Key.Y && Coords.Z >= slab.Key.Z && Coords.X < slab.Value.X && Coords.Y < slab.Value.Y && Coords.Z < slab.Value.Z)
+				return true;
+		}
+
+		return false;
+	};
+
+	// Forget whatever lived in the recycled storage. Obstacles still in view are picked up again when those voxels are sampled.
+	for (auto& obstacle : DynamicObstacleVoxels)
+	{
+		for (auto it = obstacle.Value.CreateIterator(); it; ++it)
+		{
+			if (!isScrolledIn(VoxelCoords(*it)))
+				continue;
+
+			NAVVolumeData.Unpin(*it);
+			it.RemoveCurrent();
+		}
+	}
+
+	{
+		FScopeLock lock(&VoxelCollisionNotifyeesLock);
+
+		for (auto it = VoxelCollisionNotifyees.CreateIterator(); it; ++it)
+		{
+			if (isScrolledIn(NAVVolumeData.CoordsOf(it.Key())))
+				it.RemoveCurrent();
+		}
+	}
+
+	// Neighbor lists along the old edges are no longer valid
+	NavGraphCache.Empty();
+
+	// and neither are retained search trees, which are laid out in the old coordinates
+	{
+		FScopeLock lock(&IncrementalPlannersLock);
+
+		IncrementalPlanners.Empty();
+	}
+
+	for (const auto& slab : scrolledSlabs)
+		NAVVolumeData.ResetRegion(slab.Key, slab.Value);
+
+	if (bResampleImmediately)
+	{
+		const int32 blockSize = GetVoxelSamplingBlockSize();
+
+		// Block aligned, the same way InitializeVoxel samples. Voxels outside the slabs are already initialized and simply keep their state (see ApplyVoxelSample).
+		// Slabs overlap where the window moved along several axes, so blocks are deduplicated to keep every block on a single thread.
+		TSet<FIntVector> uniqueBlocks;
+
+		for (const auto& slab : scrolledSlabs)
+			for (int32 z = slab.Key.Z & ~(blockSize - 1); z < slab.Value.Z; z += blockSize)
+				for (int32 y = slab.Key.Y & ~(blockSize - 1); y < slab.Value.Y; y += blockSize)
+					for (int32 x = slab.Key.X & ~(blockSize - 1); x < slab.Value.X; x += blockSize)
+						uniqueBlocks.Add(FIntVector(x, y, z));
+
+		const TArray<FIntVector> blocks = uniqueBlocks.Array();
+
+		ParallelFor(blocks.Num(), [&](int32 i)
+		{
+			SampleVoxelBlock(blocks[i], blockSize,
+				[this](const FVector& Center, const FVector& Extent) { return IsRegionBlocked(Center, Extent); },
+				[this](int32 x, int32 y, int32 z, bool bIsBlocked) { ApplyVoxelSample(NAVVolumeData.At(x, y, z), bIsBlocked); });
+		});
+	}
+
+	NAVVolumeDataLock.Unlock();
+
+	UE_LOG(DoNNavigationLog, Verbose, TEXT("Scrolled voxel grid by (%d, %d, %d), ring offset is now (%d, %d, %d)"), Shift.X, Shift.Y, Shift.Z, NAVVolumeData.RingOffset.X, NAVVolumeData.RingOffset.Y, NAVVolumeData.RingOffset.Z);
+
+	ReleaseHeldPathfindingQueries();
+
+	return true;
 }
 
 void ADonNavigationManager::ReceiveAsyncResults()
@@ -175,13 +536,31 @@ void ADonNavigationManager::ReceiveAsyncResults()
 	}
 }
 
+void ADonNavigationManager::BroadcastCollisionUpdates(FDonNavigationVoxel* Volume)
+{
+	// Protect ourselves from delegate owners reallocating the TArray while we're iterating:
+	TArray<FDonNavigationDynamicCollisionNotifyee> notifyees_safecopy;
+	{
+		FScopeLock lock(&VoxelCollisionNotifyeesLock);
+
+		auto notifyees = VoxelCollisionNotifyees.Find(VoxelIndex(Volume));
+		if (!notifyees)
+			return;
+
+		notifyees_safecopy = *notifyees;
+	}
+
+	for (const auto& notifyee : notifyees_safecopy)
+		notifyee.Listener.ExecuteIfBound(notifyee.Payload);
+}
+
 void ADonNavigationManager::ReceiveAsyncDynamicCollisionUpdates()
 {
 	while (!DynamicCollisionBroadcastQueue.IsEmpty())
 	{
 		FDonNavigationVoxel* voxel;
 		DynamicCollisionBroadcastQueue.Dequeue(voxel);
-		voxel->BroadcastCollisionUpdates();
+		BroadcastCollisionUpdates(voxel);
 	}
 }
 
@@ -206,193 +585,1035 @@ void ADonNavigationManager::DrawAsyncDebugRequests()
 		DrawDebugPoint(GetWorld(), point.PointLocation, point.PointThickness, point.Color, point.bPersistentLines, point.LifeTime);
 	}
 
-	while (!DrawDebugVoxelsQueue.IsEmpty())
+	while (!DrawDebugVoxelsQueue.IsEmpty())
+	{
+		FDrawDebugVoxelRequest voxel;
+		DrawDebugVoxelsQueue.Dequeue(voxel);
+		DrawDebugVoxel(GetWorld(), voxel.Center, voxel.Box, voxel.Color, voxel.bPersistentLines, voxel.LifeTime, voxel.DepthPriority, voxel.Thickness);
+	}
+
+	while (!DrawDebugSpheresQueue.IsEmpty())
+	{
+		FDrawDebugSphereRequest sphere;
+		DrawDebugSpheresQueue.Dequeue(sphere);
+		DrawDebugSphere(GetWorld(), sphere.Center, sphere.Radius, sphere.Segments, sphere.Color, sphere.bPersistentLines, sphere.LifeTime);
+	}
+
+#endif // WITH_EDITOR
+}
+
+void ADonNavigationManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UWorld* const World = GetWorld();
+
+	if (!World)
+		return;
+
+	SetupVoxelCollisionQueryParams();
+
+	UnboundOccupancyCache.SetLimits(UnboundOccupancyCacheMaxVoxels, UnboundOccupancyCacheMaxAge);
+	SearchStatePool.SetMaxPooledStates(MaxPooledSearchStates);
+
+	// Collision profiles sampled in previous sessions:
+	if (bUsePersistentVoxelCollisionProfileCache)
+	{
+		if (PersistentVoxelCollisionProfiles.Load(GetPersistentVoxelCollisionProfileFilename()))
+			UE_LOG(DoNNavigationLog, Log, TEXT("Loaded %d persistent voxel collision profiles"), PersistentVoxelCollisionProfiles.Num());
+	}
+
+	// Misc:
+	VoxelSizeSquared = VoxelSize * VoxelSize;
+
+	// Generate the world:
+	ConstructBuilder();
+
+	ActiveDynamicCollisionTasks.Reserve(60);
+
+	RefreshPerformanceSettings();
+
+	// Spawn dedicated worker thread:
+	if (bMultiThreadingEnabled)
+		WorkerThread = new FDonNavigationWorker(this, MaxPathSolverIterationsOnThread, MaxCollisionSolverIterationsOnThread);
+}
+
+void ADonNavigationManager::SetupVoxelCollisionQueryParams()
+{
+	//Setup common collision parameters:
+	VoxelCollisionShape = FCollisionShape::MakeBox(NavVolumeExtent());
+
+	VoxelCollisionQueryParams = FCollisionQueryParams(FName("DonCollisionQuery", false)); // trace complex = false	
+	VoxelCollisionQueryParams.AddIgnoredActors(ActorsToIgnoreForCollision);	
+
+	VoxelCollisionQueryParams2 = FCollisionQueryParams(VoxelCollisionQueryParams);
+	VoxelCollisionQueryParams2.bFindInitialOverlaps = false;
+
+	VoxelCollisionObjectParams = FCollisionObjectQueryParams();
+
+	for (auto collisionChannel : ObstacleQueryChannels)
+		VoxelCollisionObjectParams.AddObjectTypesToQuery(collisionChannel);
+}
+
+void ADonNavigationManager::RefreshPerformanceSettings()
+{
+	if (bIsUnbound)
+	{
+		// Transfer Infinite World performance settings:
+		MaxPathSolverIterationsPerTick = MaxPathSolverIterationsPerTick_Unbound;
+		MaxCollisionSolverIterationsPerTick = MaxCollisionSolverIterationsPerTick_Unbound;
+		MaxPathSolverIterationsOnThread = MaxPathSolverIterationsOnThread_Unbound;
+		MaxCollisionSolverIterationsOnThread = MaxCollisionSolverIterationsOnThread_Unbound;
+	}
+}
+
+void ADonNavigationManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{	
+	if (WorkerThread)
+	{
+		WorkerThread->ShutDown();
+	}
+
+	if (bUsePersistentVoxelCollisionProfileCache && !PersistentVoxelCollisionProfiles.Save(GetPersistentVoxelCollisionProfileFilename()))
+		UE_LOG(DoNNavigationLog, Warning, TEXT("Failed to save persistent voxel collision profiles to %s"), *GetPersistentVoxelCollisionProfileFilename());
+}
+
+FString ADonNavigationManager::GetPersistentVoxelCollisionProfileFilename()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DonNavigation"), TEXT("VoxelCollisionProfiles.bin"));
+}
+
+FString ADonNavigationManager::GetPersistentVoxelCollisionProfileKey(const FDonMeshIdentifier& ProfileId, bool bCenteredInVoxel, bool bIgnoreMeshOriginOccupancy, bool bUseCheapBoundsCollision, float BoundsScaleFactor)
+{
+	auto Mesh = ProfileId.Mesh.Get();
+	const FName CustomCacheIdentifier = ProfileId.CustomCacheIdentifier;
+
+	// Reads bounds, pose and body setups of the live component. Dynamic collision tasks capture the key while being prepared instead:
+	if (!ensure(IsInGameThread()) || !bUsePersistentVoxelCollisionProfileCache || !Mesh)
+		return FString();
+
+	// Whatever shape the occupancy was sampled from:
+	FString shape;
+
+	auto staticMesh = Cast<UStaticMeshComponent>(Mesh);
+	auto skeletalMesh = Cast<USkeletalMeshComponent>(Mesh);
+
+	if (!CustomCacheIdentifier.IsNone())
+		shape = CustomCacheIdentifier.ToString();
+	else if (staticMesh && staticMesh->GetStaticMesh())
+		shape = staticMesh->GetStaticMesh()->GetPathName();
+	else if (skeletalMesh && skeletalMesh->SkeletalMesh)
+		shape = skeletalMesh->SkeletalMesh->GetPathName();
+	else // shape components etc. are described by their class and local bounds
+		shape = FString::Printf(TEXT("%s%s"), *Mesh->GetClass()->GetPathName(), *Mesh->CalcBounds(FTransform::Identity).BoxExtent.ToCompactString());
+
+	// ...and how it was placed in the world and sampled:
+	FString pose;
+
+	if (ProfileId.bIsPosed)
+	{
+		pose = FString::Printf(TEXT("S=%s/%.3f|R=%s/%.1f"), *ProfileId.ScaleBucket.ToString(), CollisionProfileScaleStep, *ProfileId.RotationBucket.ToString(), CollisionProfileRotationStep);
+	}
+	else
+	{
+		const FVector scale = Mesh->GetComponentScale();
+		const FRotator rotation = Mesh->GetComponentRotation();
+
+		pose = FString::Printf(TEXT("S=%.3f,%.3f,%.3f|R=%.0f,%.0f,%.0f"), scale.X, scale.Y, scale.Z, rotation.Pitch, rotation.Yaw, rotation.Roll);
+	}
+
+	// Cheap bounds collision only ever looks at the bounds, which are already part of the pose
+	const uint32 fingerprint = bUseCheapBoundsCollision ? 0 : GetCollisionGeometryFingerprint(Mesh);
+
+	return FString::Printf(TEXT("%s#%08x|%s|V=%.2f|B=%.3f|%d%d%d"), *shape, fingerprint, *pose, VoxelSize, BoundsScaleFactor, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, bUseCheapBoundsCollision);
+}
+
+uint32 ADonNavigationManager::GetCollisionGeometryFingerprint(UPrimitiveComponent* Mesh)
+{
+	TArray<UBodySetup*> bodySetups;
+
+	auto skeletalMesh = Cast<USkeletalMeshComponent>(Mesh);
+	auto physicsAsset = skeletalMesh ? skeletalMesh->GetPhysicsAsset() : nullptr;
+
+	if (physicsAsset)
+		bodySetups.Append(physicsAsset->SkeletalBodySetups);
+	else
+		bodySetups.Add(Mesh->GetBodySetup());
+
+	uint32 hash = 0;
+
+	for (auto bodySetup : bodySetups)
+	{
+		if (!bodySetup)
+			continue;
+
+		// The guid changes whenever cooked collision is invalidated (including complex collision rebuilt from render geometry)...
+		hash = HashCombine(hash, GetTypeHash(bodySetup->BodySetupGuid));
+		hash = HashCombine(hash, (uint32)bodySetup->CollisionTraceFlag);
+
+		// ...while the simple shapes are hashed directly, as editing those in place doesn't always regenerate it:
+		const auto& geometry = bodySetup->AggGeom;
+
+		for (const auto& element : geometry.BoxElems)
+		{
+			hash = FCrc::MemCrc32(&element.Center, sizeof(FVector), hash);
+			hash = FCrc::MemCrc32(&element.Rotation, sizeof(FRotator), hash);
+			hash = HashCombine(hash, HashCombine(GetTypeHash(element.X), HashCombine(GetTypeHash(element.Y), GetTypeHash(element.Z))));
+		}
+
+		for (const auto& element : geometry.SphereElems)
+		{
+			hash = FCrc::MemCrc32(&element.Center, sizeof(FVector), hash);
+			hash = HashCombine(hash, GetTypeHash(element.Radius));
+		}
+
+		for (const auto& element : geometry.SphylElems)
+		{
+			hash = FCrc::MemCrc32(&element.Center, sizeof(FVector), hash);
+			hash = FCrc::MemCrc32(&element.Rotation, sizeof(FRotator), hash);
+			hash = HashCombine(hash, HashCombine(GetTypeHash(element.Radius), GetTypeHash(element.Length)));
+		}
+
+		for (const auto& element : geometry.ConvexElems)
+			hash = FCrc::MemCrc32(element.VertexData.GetData(), element.VertexData.Num() * sizeof(FVector), hash);
+	}
+
+	return hash;
+}
+
+FDonMeshIdentifier ADonNavigationManager::GetCollisionProfileId(const FDonMeshIdentifier& MeshId)
+{
+	auto mesh = MeshId.Mesh.Get();
+	if (!bPoseAwareCollisionProfileCache || !mesh || MeshId.bIsPosed)
+		return MeshId;
+
+	// The pose is read off the live component, so dynamic collision tasks capture their profile id while being prepared:
+	ensure(IsInGameThread());
+
+	const float rotationStep = FMath::Clamp(CollisionProfileRotationStep, 1.f, 90.f);
+	const float scaleStep = FMath::Max(CollisionProfileScaleStep, 0.01f);
+	const int32 numRotationBuckets = FMath::RoundToInt(360.f / rotationStep);
+
+	auto rotationBucket = [rotationStep, numRotationBuckets](float Angle) { return FMath::RoundToInt(FRotator::ClampAxis(Angle) / rotationStep) % numRotationBuckets; };
+	auto scaleBucket = [scaleStep](float Scale) { return FMath::RoundToInt(Scale / scaleStep); };
+
+	const FRotator rotation = mesh->GetComponentRotation();
+	const FVector scale = mesh->GetComponentScale();
+
+	return MeshId.WithPose(FIntVector(rotationBucket(rotation.Pitch), rotationBucket(rotation.Yaw), rotationBucket(rotation.Roll)), FIntVector(scaleBucket(scale.X), scaleBucket(scale.Y), scaleBucket(scale.Z)));
+}
+
+bool ADonNavigationManager::RasterizeVoxelCollisionForMesh(UPrimitiveComponent* Mesh, bool bCenteredInVoxel, bool bIgnoreMeshOriginOccupancy, float BoundsScaleFactor, FDonVoxelCollisionProfile& OutProfile)
+{
+	// Reads the body setup and live transform of the component, so this must never run on the worker. Dynamic collision tasks are
+	// rasterized once while being prepared on the game thread and the worker only ever consumes the profile captured there:
+	if (!ensure(IsInGameThread()))
+		return false;
+
+	// (shrunken bounds clip the sampled occupancy, which is only supported by the samplers)
+	if (!bUseAnalyticVoxelization || !Mesh || BoundsScaleFactor < 1.f)
+		return false;
+
+	// Only shapes the samplers would see count as obstacles. Leave the rest to them, along with their error handling:
+	if (Mesh->GetCollisionProfileName().IsEqual(FName("NoCollision")) || !Mesh->IsQueryCollisionEnabled())
+		return false;
+
+	if (!(VoxelCollisionObjectParams.GetQueryBitfield() & ECC_TO_BITFIELD(Mesh->GetCollisionObjectType())))
+		return false;
+
+	if (Mesh->GetOwner() && ActorsToIgnoreForCollision.Contains(Mesh->GetOwner()))
+		return false;
+
+	TArray<FDonCollisionPrimitive> primitives;
+	if (!FDonVoxelRasterizer::CapturePrimitives(Mesh, primitives))
+		return false;
+
+	auto meshOriginVolume = VolumeAt(Mesh->GetComponentLocation());
+	if (!meshOriginVolume)
+		return false;
+
+	const FVector pivotOffset = bCenteredInVoxel ? FVector::ZeroVector : Mesh->GetComponentLocation() - VoxelLocation(meshOriginVolume);
+
+	OutProfile.RelativeVoxelOccupancy.Reset();
+	FDonVoxelRasterizer::Rasterize(primitives, pivotOffset, VoxelSize, OutProfile.RelativeVoxelOccupancy);
+
+	if (bIgnoreMeshOriginOccupancy)
+		OutProfile.RelativeVoxelOccupancy.Remove(FVector::ZeroVector);
+
+	return true;
+}
+
+bool ADonNavigationManager::OverlapsMeshInPlace(UPrimitiveComponent* Mesh, const FVector& VoxelCenter, const FTransform& SamplingTransform)
+{
+	const FTransform& currentTransform = Mesh->GetComponentTransform();
+
+	const FVector location = currentTransform.TransformPositionNoScale(SamplingTransform.InverseTransformPositionNoScale(VoxelCenter));
+	const FQuat rotation = currentTransform.GetRotation() * SamplingTransform.GetRotation().Inverse();
+
+	return Mesh->OverlapComponent(location, rotation, VoxelCollisionShape);
+}
+
+void ADonNavigationManager::AddSampledCollisionProfile(const FDonSampledCollisionProfileKey& Key, const FDonSampledCollisionProfile& Profile)
+{
+	FScopeLock lock(&SampledCollisionProfilesLock);
+
+	SampledCollisionProfiles.Add(Key, Profile);
+}
+
+bool ADonNavigationManager::DeriveCollisionProfileForPose(const FDonSampledCollisionProfileKey& Key, const FQuat& Rotation, const FVector& Scale, FDonVoxelCollisionProfile& OutProfile)
+{
+	if (!bDeriveCollisionProfilesForNewPoses)
+		return false;
+
+	// (work on a copy, the other thread may add profiles in the meantime)
+	FDonSampledCollisionProfile source;
+
+	{
+		FScopeLock lock(&SampledCollisionProfilesLock);
+
+		const auto found = SampledCollisionProfiles.Find(Key);
+		if (!found)
+			return false;
+
+		source = *found;
+	}
+
+	if (source.Scale.GetAbsMin() < KINDA_SMALL_NUMBER)
+		return false;
+
+	// Offsets are relative to the mesh origin in both poses, so undoing the sampled pose and applying the new one maps one profile onto the other:
+	const FMatrix sourcePose = FScaleRotationTranslationMatrix(source.Scale, source.Rotation.Rotator(), FVector::ZeroVector);
+	const FMatrix targetPose = FScaleRotationTranslationMatrix(Scale, Rotation.Rotator(), FVector::ZeroVector);
+	const FMatrix sourceToTarget = sourcePose.Inverse() * targetPose;
+
+	// Each occupied voxel is carried over as a grid of points so that stretched voxels still cover every voxel they land on:
+	float maxStretch = 1.f;
+	for (int32 axis = 0; axis < 3; axis++)
+		maxStretch = FMath::Max(maxStretch, FMath::Abs(sourceToTarget.M[0][axis]) + FMath::Abs(sourceToTarget.M[1][axis]) + FMath::Abs(sourceToTarget.M[2][axis]));
+
+	const int32 pointsPerAxis = FMath::Clamp(FMath::CeilToInt(maxStretch * 2.f), 2, 8);
+
+	TSet<FIntVector> occupied;
+	occupied.Reserve(source.RelativeVoxelOccupancy.Num());
+
+	for (const auto& offset : source.RelativeVoxelOccupancy)
+	{
+		for (int32 i = 0; i < pointsPerAxis; i++)
+		{
+			for (int32 j = 0; j < pointsPerAxis; j++)
+			{
+				for (int32 k = 0; k < pointsPerAxis; k++)
+				{
+					const FVector point = offset + (FVector(i, j, k) + 0.5f) / pointsPerAxis - 0.5f;
+					const FVector transformed = sourceToTarget.TransformVector(point);
+
+					occupied.Add(FIntVector(FMath::RoundToInt(transformed.X), FMath::RoundToInt(transformed.Y), FMath::RoundToInt(transformed.Z)));
+				}
+			}
+		}
+	}
+
+	if (Key.bIgnoreMeshOriginOccupancy)
+		occupied.Remove(FIntVector::ZeroValue);
+
+	OutProfile.RelativeVoxelOccupancy.Empty(occupied.Num());
+
+	for (const auto& voxel : occupied)
+		OutProfile.RelativeVoxelOccupancy.Add(FVector(voxel));
+
+	return true;
+}
+
+void ADonNavigationManager::OnConstruction(const FTransform& Transform)
+{	
+	Super::OnConstruction(Transform);
+
+	Debug_RecalculateWorldBounds();
+}
+
+#if WITH_EDITOR
+void ADonNavigationManager::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{	
+	UProperty* PropertyThatChanged = PropertyChangedEvent.Property;
+	FName PropertyName = PropertyThatChanged != NULL ? PropertyThatChanged->GetFName() : NAME_None;
+	
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, bDisplayWorldBoundary))
+	{
+		Debug_RecalculateWorldBounds();
+		WorldBoundaryVisualizer->SetVisibility(bDisplayWorldBoundary);		
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, bDisplayWorldBoundaryInGame))
+	{
+		WorldBoundaryVisualizer->SetHiddenInGame(!bDisplayWorldBoundaryInGame);
+	}
+	else
+	{
+		bool bWorldBoundsChanged = PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, VoxelSize)
+								|| PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, XGridSize)
+								|| PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, YGridSize)
+								|| PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, ZGridSize);
+
+		if (bWorldBoundsChanged)
+		{
+			Debug_RecalculateWorldBounds();
+		}
+	}	
+
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+#endif // WITH_EDITOR
+
+void ADonNavigationManager::ConstructBuilder()
+{
+	UWorld* const World = GetWorld();
+	if (!World)
+		return;
+
+	if (bIsUnbound)
+		return;
+	
+	uint64 timer = DoNNavigation::Debug_GetTimer();	
+	GenerateNavigationVolumePixels();
+	DoNNavigation::Debug_StopTimer(timer);
+
+	UE_LOG(DoNNavigationLog, Log, TEXT("Time spent generating %d NAV volumes: %f seconds"), XGridSize * YGridSize * ZGridSize, timer / 1000.0);
+
+	UE_LOG(DoNNavigationLog, Log, TEXT("NAV grid memory: %d bytes per voxel, %.2f MB reserved, %.2f MB committed. Pages of %d bricks are committed on first use."),
+		(int32)sizeof(FDonNavigationVoxel), NAVVolumeData.GetReservedSize() / (1024.0 * 1024.0), NAVVolumeData.GetCommittedSize() / (1024.0 * 1024.0), NAVVolumeData.BricksPerPage());
+
+	if (bUseSparseVoxelOctree)
+	{
+		uint64 timerOctree = DoNNavigation::Debug_GetTimer();
+		BuildSparseVoxelOctree();
+		DoNNavigation::Debug_StopTimer(timerOctree);
+
+		if (SparseVoxelOctree.IsValid())
+			UE_LOG(DoNNavigationLog, Log, TEXT("Sparse voxel octree: %d nodes, %d leaves covering %d voxels (%.2f MB). Built in %f seconds"),
+				SparseVoxelOctree.Nodes.Num(), SparseVoxelOctree.NumLeaves(), NAVVolumeData.Num(), SparseVoxelOctree.GetAllocatedSize() / (1024.0 * 1024.0), timerOctree / 1000.0);
+	}
+
+	if (bUseHierarchicalPathfinding)
+	{
+		uint64 timerHierarchicalGraph = DoNNavigation::Debug_GetTimer();
+		BuildHierarchicalGraph();
+		DoNNavigation::Debug_StopTimer(timerHierarchicalGraph);
+
+		UE_LOG(DoNNavigationLog, Log, TEXT("Hierarchical graph: %d clusters of %d voxels per side, %d derived up front, %d entrances (%.2f MB). Built in %f seconds"),
+			HierarchicalGraph.Clusters.Num(), HierarchicalGraph.GetClusterSize(), HierarchicalGraph.NumDerivedClusters(), HierarchicalGraph.Nodes.Num(), HierarchicalGraph.GetAllocatedSize() / (1024.0 * 1024.0), timerHierarchicalGraph / 1000.0);
+	}
+
+	if (bRejectUnreachableQueries)
+	{
+		uint64 timerConnectivity = DoNNavigation::Debug_GetTimer();
+		BuildConnectivity();
+		DoNNavigation::Debug_StopTimer(timerConnectivity);
+
+		if (Connectivity.IsValid())
+			UE_LOG(DoNNavigationLog, Log, TEXT("Connectivity: %d components (%.2f MB). Labeled in %f seconds"), Connectivity.NumComponents(), Connectivity.GetAllocatedSize() / (1024.0 * 1024.0), timerConnectivity / 1000.0);
+	}
+
+	
+	// This snippet is useful for studying and profiling behavior of the Nav Graph Cache behavior at full load. Not recommended for production.
+	/*uint64 timerNAVNetwork = DoNNavigation::Debug_GetTimer();
+	BuildNAVNetwork();
+	DoNNavigation::Debug_StopTimer(timerNAVNetwork);
+	
+	UE_LOG(DoNNavigationLog, Log, TEXT("%s"), *FString::Printf(TEXT("Time spent building NAV network: %f seconds"), timerNAVNetwork / 1000.0));*/
+}
+
+void ADonNavigationManager::GenerateNavigationVolumePixels()
+{
+	UWorld* const World = GetWorld();
+
+	if (!World)
+		return;	
+
+	// Only address space is reserved here, voxel bricks are committed as queries, collision tasks and debug draws first touch them:
+	NAVVolumeData.Init(XGridSize, YGridSize, ZGridSize);
+
+	// With a baked grid, static occupancy is simply read from disk as voxels are initialized:
+	if (bUseBakedNavigationGrid && LoadBakedNavigationGrid())
+		return;
+
+	if (!PerformCollisionChecksOnStartup)
+		return;
+
+	BakeVoxelCollisions();
+}
+
+void ADonNavigationManager::BakeVoxelCollisions()
+{
+	// The bake is split into rows of bricks (8 voxels tall and deep, spanning the world along X) that are sampled in parallel.
+	// Overlap queries against the scene are read-only and every row writes to its own voxels, so rows need no synchronization.
+	const int32 brickSize = FDonNavVoxelGrid::BrickMask + 1;
+	const int32 yRows = FMath::DivideAndRoundUp(YGridSize, brickSize);
+	const int32 numRows = yRows * FMath::DivideAndRoundUp(ZGridSize, brickSize);
+
+	// Brick rows are further split into coarse sampling blocks (see VoxelSamplingBlockSize):
+	const int32 blockSize = GetVoxelSamplingBlockSize();
+
+	auto isRegionBlocked = [this](const FVector& Center, const FVector& Extent) { return IsRegionBlocked(Center, Extent); };
+	auto applyVoxelSample = [this](int32 x, int32 y, int32 z, bool bIsBlocked) { ApplyVoxelSample(NAVVolumeData.At(x, y, z), bIsBlocked); };
+
+	auto bakeRow = [&](int32 Row)
+	{
+		const int32 yStart = (Row % yRows) * brickSize;
+		const int32 zStart = (Row / yRows) * brickSize;
+		const int32 yEnd = FMath::Min(yStart + brickSize, YGridSize);
+		const int32 zEnd = FMath::Min(zStart + brickSize, ZGridSize);
+
+		if (blockSize == 1)
+		{
+			for (int32 z = zStart; z < zEnd; z++)
+				for (int32 y = yStart; y < yEnd; y++)
+					for (int32 x = 0; x < XGridSize; x++)
+						UpdateVoxelCollision(NAVVolumeData.At(x, y, z));
+
+			return;
+		}
+
+		for (int32 z = zStart; z < zEnd; z += blockSize)
+			for (int32 y = yStart; y < yEnd; y += blockSize)
+				for (int32 x = 0; x < XGridSize; x += blockSize)
+					SampleVoxelBlock(FIntVector(x, y, z), blockSize, isRegionBlocked, applyVoxelSample);
+	};
+
+	// Rows are dispatched in batches so that we can report progress and honor cancellation in between:
+	const int32 numBatches = FMath::Min(numRows, 100);
+	const int32 rowsPerBatch = FMath::DivideAndRoundUp(numRows, numBatches);
+
+	FScopedSlowTask slowTask(numRows, NSLOCTEXT("DonNavigation", "BakingVoxelCollisions", "Baking voxel collisions..."));
+	slowTask.MakeDialog(true /*bShowCancelButton*/);
+
+	int32 rowsBaked = 0;
+	int32 lastLoggedPercent = 0;
+
+	while (rowsBaked < numRows)
+	{
+		if (slowTask.ShouldCancel())
+		{
+			// Anything we haven't sampled yet is simply lazy loaded on demand, same as with PerformCollisionChecksOnStartup disabled
+			UE_LOG(DoNNavigationLog, Warning, TEXT("Voxel collision bake cancelled after %d/%d brick rows. Remaining voxels will be sampled on demand."), rowsBaked, numRows);
+			return;
+		}
+
+		const int32 batchStart = rowsBaked;
+		const int32 batchSize = FMath::Min(rowsPerBatch, numRows - rowsBaked);
+
+		ParallelFor(batchSize, [&](int32 i) { bakeRow(batchStart + i); });
+
+		rowsBaked += batchSize;
+		slowTask.EnterProgressFrame(batchSize);
+
+		const int32 percent = (100 * rowsBaked) / numRows;
+		if (percent >= lastLoggedPercent + 10 || rowsBaked == numRows)
+		{
+			UE_LOG(DoNNavigationLog, Log, TEXT("Baking voxel collisions: %d%% (%d/%d brick rows)"), percent, rowsBaked, numRows);
+			lastLoggedPercent = percent;
+		}
+	}
+}
+
+FDonBakedNavigationGridHeader ADonNavigationManager::MakeBakedNavigationGridHeader()
+{
+	FDonBakedNavigationGridHeader header;
+
+	header.VoxelSize = VoxelSize;
+	header.XGridSize = XGridSize;
+	header.YGridSize = YGridSize;
+	header.ZGridSize = ZGridSize;
+	header.Origin = GetActorLocation();
+	header.bSkipsMovableObstacles = bBakeSkipsMovableObstacles;
+
+	for (auto collisionChannel : ObstacleQueryChannels)
+		header.ObstacleChannels |= 1ull << (uint8)collisionChannel;
+
+	return header;
+}
+
+FString ADonNavigationManager::GetBakedNavigationGridFilename()
+{
+	// Stored alongside the level, eg: Content/Maps/MyLevel_DonNavigationManager_1.donnav
+	const FString levelPackageName = UWorld::RemovePIEPrefix(GetOutermost()->GetName());
+
+	return FPackageName::LongPackageNameToFilename(levelPackageName, FString::Printf(TEXT("_%s.donnav"), *GetName()));
+}
+
+bool ADonNavigationManager::LoadBakedNavigationGrid()
+{
+	const FString filename = GetBakedNavigationGridFilename();
+
+	if (!BakedNavigationGrid.Load(filename, MakeBakedNavigationGridHeader()))
+	{
+		UE_LOG(DoNNavigationLog, Log, TEXT("No usable baked navigation grid found at %s, voxel collisions will be sampled at runtime"), *filename);
+		return false;
+	}
+
+	UE_LOG(DoNNavigationLog, Log, TEXT("Loaded baked navigation grid %s"), *filename);
+
+	return true;
+}
+
+bool ADonNavigationManager::IsRegionBlockedForBake(const FVector& Center, const FVector& Extent)
+{
+	// Same test as the live sampler, so a baked grid never disagrees with lazy loading:
+	if (!bBakeSkipsMovableObstacles)
+		return IsRegionBlocked(Center, Extent);
+
+	TArray<FOverlapResult> outOverlaps;
+
+	GetWorld()->OverlapMultiByObjectType(outOverlaps, Center, FQuat::Identity, VoxelCollisionObjectParams, FCollisionShape::MakeBox(Extent), VoxelCollisionQueryParams);
+
+	for (const auto& overlap : outOverlaps)
+	{
+		// Opted out: movable obstacles report their occupancy through dynamic collision updates instead
+		auto component = overlap.GetComponent();
+		if (component && component->Mobility != EComponentMobility::Movable)
+			return true;
+	}
+
+	return false;
+}
+
+void ADonNavigationManager::BakeNavigationGrid()
+{
+	UWorld* const World = GetWorld();
+
+	if (!World || bIsUnbound)
+	{
+		UE_LOG(DoNNavigationLog, Error, TEXT("Navigation grids can only be baked for finite worlds"));
+		return;
+	}
+
+	SetupVoxelCollisionQueryParams();
+
+	const FDonBakedNavigationGridHeader header = MakeBakedNavigationGridHeader();
+
+	TArray<uint8> blockedVoxels;
+	blockedVoxels.SetNumZeroed(header.NumVoxels());
+
+	// Each slab of coarse sampling blocks is sampled in parallel, one row of blocks per job:
+	const int32 blockSize = GetVoxelSamplingBlockSize();
+	const int32 numSlabs = FMath::DivideAndRoundUp(ZGridSize, blockSize);
+
+	auto isRegionBlocked = [this](const FVector& Center, const FVector& Extent) { return IsRegionBlockedForBake(Center, Extent); };
+	auto recordVoxelSample = [&](int32 x, int32 y, int32 z, bool bIsBlocked) { blockedVoxels[x + y * XGridSize + z * XGridSize * YGridSize] = bIsBlocked ? 1 : 0; };
+
+	FScopedSlowTask slowTask(numSlabs, NSLOCTEXT("DonNavigation", "BakingNavigationGrid", "Baking navigation grid..."));
+	slowTask.MakeDialog(true /*bShowCancelButton*/);
+
+	for (int32 z = 0; z < ZGridSize; z += blockSize)
+	{
+		if (slowTask.ShouldCancel())
+		{
+			UE_LOG(DoNNavigationLog, Warning, TEXT("Navigation grid bake cancelled, nothing was written"));
+			return;
+		}
+
+		ParallelFor(FMath::DivideAndRoundUp(YGridSize, blockSize), [&](int32 yBlock)
+		{
+			for (int32 x = 0; x < XGridSize; x += blockSize)
+				SampleVoxelBlock(FIntVector(x, yBlock * blockSize, z), blockSize, isRegionBlocked, recordVoxelSample);
+		});
+
+		slowTask.EnterProgressFrame();
+	}
+
+	const FString filename = GetBakedNavigationGridFilename();
+
+	if (FDonBakedNavigationGrid::Save(filename, header, blockedVoxels))
+		UE_LOG(DoNNavigationLog, Log, TEXT("Baked navigation grid for %d voxels to %s (%lld bytes)"), blockedVoxels.Num(), *filename, header.GetFileSize());
+	else
+		UE_LOG(DoNNavigationLog, Error, TEXT("Failed to write baked navigation grid to %s"), *filename);
+}
+
+int32 ADonNavigationManager::GetVoxelSamplingBlockSize()
+{
+	return FMath::RoundUpToPowerOfTwo(FMath::Clamp(VoxelSamplingBlockSize, 1, FDonNavVoxelGrid::BrickMask + 1));
+}
+
+bool ADonNavigationManager::IsRegionBlocked(const FVector& Center, const FVector& Extent)
+{
+	return GetWorld()->OverlapAnyTestByObjectType(Center, FQuat::Identity, VoxelCollisionObjectParams, FCollisionShape::MakeBox(Extent), VoxelCollisionQueryParams);
+}
+
+void ADonNavigationManager::SampleVoxelBlock(const FIntVector& Min, int32 Size, TFunctionRef<bool(const FVector& Center, const FVector& Extent)> IsRegionBlockedFn, TFunctionRef<void(int32 x, int32 y, int32 z, bool bIsBlocked)> OnVoxelSampled)
+{
+	const FIntVector max(FMath::Min(Min.X + Size, XGridSize), FMath::Min(Min.Y + Size, YGridSize), FMath::Min(Min.Z + Size, ZGridSize));
+
+	if (Min.X >= max.X || Min.Y >= max.Y || Min.Z >= max.Z)
+		return;
+
+	// A single voxel's box is exactly what UpdateVoxelCollision tests, larger blocks are just the union of their voxels' boxes
+	const FVector extent = FVector(Size * VoxelSize / 2);
+	const FVector center = GetActorLocation() + VoxelSize * FVector(Min) + extent;
+
+	const bool bIsBlocked = IsRegionBlockedFn(center, extent);
+
+	if (Size == 1 || !bIsBlocked)
+	{
+		for (int32 z = Min.Z; z < max.Z; z++)
+			for (int32 y = Min.Y; y < max.Y; y++)
+				for (int32 x = Min.X; x < max.X; x++)
+					OnVoxelSampled(x, y, z, bIsBlocked);
+
+		return;
+	}
+
+	const int32 half = Size / 2;
+
+	for (int32 i = 0; i < 8; i++)
+		SampleVoxelBlock(Min + FIntVector(i & 1, (i >> 1) & 1, (i >> 2) & 1) * half, half, IsRegionBlockedFn, OnVoxelSampled);
+}
+
+void ADonNavigationManager::ApplyVoxelSample(FDonNavigationVoxel& Volume, bool bIsBlocked)
+{
+	// Voxels sampled earlier (individually or as part of another block) keep their state
+	if (Volume.bIsInitialized)
+		return;
+
+	if (bIsBlocked)
+		Volume.SetNavigability(false);
+
+	Volume.bIsInitialized = true;
+}
+
+void ADonNavigationManager::InitializeVoxel(FDonNavigationVoxel& Volume)
+{
+	const FIntVector coords = VoxelCoords(&Volume);
+	const int32 blockSize = BakedNavigationGrid.IsLoaded() ? 1 : GetVoxelSamplingBlockSize();
+	const FIntVector blockMin(coords.X & ~(blockSize - 1), coords.Y & ~(blockSize - 1), coords.Z & ~(blockSize - 1));
+
+	if (BakedNavigationGrid.IsLoaded())
+	{
+		InitializeVoxelFromBakedGrid(Volume);
+	}
+	else if (blockSize == 1)
+	{
+		UpdateVoxelCollision(Volume);
+	}
+	else
+	{
+		// Sample the entire aligned block around this voxel, the solver is very likely to ask for its neighbors next
+		SampleVoxelBlock(blockMin, blockSize,
+			[this](const FVector& Center, const FVector& Extent) { return IsRegionBlocked(Center, Extent); },
+			[this](int32 x, int32 y, int32 z, bool bIsBlocked) { ApplyVoxelSample(NAVVolumeData.At(x, y, z), bIsBlocked); });
+	}
+
+	// Voxels can open up without a dynamic collision update (re-sampled after their brick was evicted, or sampled differently than when labeled):
+	if (Connectivity.IsValid())
+		ReconcileConnectivityWithSamples(blockMin, blockSize);
+}
+
+void ADonNavigationManager::InitializeVoxelFromBakedGrid(FDonNavigationVoxel& Volume)
+{
+	const FIntVector coords = VoxelCoords(&Volume);
+
+	Volume.SetNavigability(!BakedNavigationGrid.IsBlocked(coords.X, coords.Y, coords.Z));
+	Volume.bIsInitialized = true;
+}
+
+void ADonNavigationManager::BuildSparseVoxelOctree()
+{
+	TFunction<bool(int32, int32, int32)> isVoxelBlocked;
+
+	if (BakedNavigationGrid.IsLoaded())
+		isVoxelBlocked = [this](int32 x, int32 y, int32 z) { return BakedNavigationGrid.IsBlocked(x, y, z); };
+	// Every voxel has just been sampled, building only reads them:
+	else if (PerformCollisionChecksOnStartup)
+		isVoxelBlocked = [this](int32 x, int32 y, int32 z) { return !CanNavigate(&VolumeAtUnsafe(x, y, z)); };
+	// Building would sample the entire world here. Queries search the voxel grid while the octree isn't valid:
+	else
+	{
+		UE_LOG(DoNNavigationLog, Warning, TEXT("bUseSparseVoxelOctree needs a baked navigation grid or PerformCollisionChecksOnStartup, queries will search the voxel grid instead"));
+		return;
+	}
+
+	// (regions passed in always lie entirely within the world, see FDonSparseVoxelOctree::BuildNode)
+	auto isRegionFree = [&isVoxelBlocked](const FIntVector& Min, int32 Size)
+	{
+		for (int32 z = Min.Z; z < Min.Z + Size; z++)
+			for (int32 y = Min.Y; y < Min.Y + Size; y++)
+				for (int32 x = Min.X; x < Min.X + Size; x++)
+				{
+					if (isVoxelBlocked(x, y, z))
+						return false;
+				}
+
+		return true;
+	};
+
+	FRWScopeLock lock(SparseVoxelOctreeLock, SLT_Write);
+
+	SparseVoxelOctree.Build(FIntVector(XGridSize, YGridSize, ZGridSize), isRegionFree);
+}
+
+bool ADonNavigationManager::IsSparseNodeNavigable(int32 NodeIndex)
+{
+	const auto& node = SparseVoxelOctree.Nodes[NodeIndex];
+
+	// Larger leaves were found to be free when the octree was built and are split as soon as a dynamic obstacle moves into them
+	if (node.Size > 1)
+		return true;
+
+	return CanNavigate(&VolumeAtUnsafe(node.Min.X, node.Min.Y, node.Min.Z));
+}
+
+FVector ADonNavigationManager::SparseNodeLocation(int32 NodeIndex)
+{
+	return GetActorLocation() + VoxelSize * FDonSparseVoxelOctree::NodeCenter(SparseVoxelOctree.Nodes[NodeIndex]);
+}
+
+FVector ADonNavigationManager::SparsePortalLocation(int32 NodeA, int32 NodeB)
+{
+	return GetActorLocation() + VoxelSize * FDonSparseVoxelOctree::PortalBetween(SparseVoxelOctree.Nodes[NodeA], SparseVoxelOctree.Nodes[NodeB]);
+}
+
+void ADonNavigationManager::BuildConnectivity()
+{
+	const FIntVector gridSize(XGridSize, YGridSize, ZGridSize);
+
+	// Labeled off to the side: sampling voxels reconciles them with Connectivity, which must not be valid (nor locked) until labeling is complete
+	FDonNavigationConnectivity connectivity;
+
+	if (BakedNavigationGrid.IsLoaded())
 	{
-		FDrawDebugVoxelRequest voxel;
-		DrawDebugVoxelsQueue.Dequeue(voxel);
-		DrawDebugVoxel(GetWorld(), voxel.Center, voxel.Box, voxel.Color, voxel.bPersistentLines, voxel.LifeTime, voxel.DepthPriority, voxel.Thickness);
+		connectivity.Build(gridSize, [this](const FIntVector& Voxel) { return !BakedNavigationGrid.IsBlocked(Voxel.X, Voxel.Y, Voxel.Z); });
 	}
-
-	while (!DrawDebugSpheresQueue.IsEmpty())
+	// Every voxel has just been sampled, labeling only reads them:
+	else if (PerformCollisionChecksOnStartup)
 	{
-		FDrawDebugSphereRequest sphere;
-		DrawDebugSpheresQueue.Dequeue(sphere);
-		DrawDebugSphere(GetWorld(), sphere.Center, sphere.Radius, sphere.Segments, sphere.Color, sphere.bPersistentLines, sphere.LifeTime);
+		connectivity.Build(gridSize, [this](const FIntVector& Voxel) { return CanNavigate(&VolumeAtUnsafe(Voxel.X, Voxel.Y, Voxel.Z)); });
+	}
+	// Labeling would sample the entire world here. Queries are never rejected while Connectivity isn't valid:
+	else
+	{
+		UE_LOG(DoNNavigationLog, Warning, TEXT("bRejectUnreachableQueries needs a baked navigation grid or PerformCollisionChecksOnStartup, unreachable queries won't be rejected"));
+		return;
 	}
 
-#endif // WITH_EDITOR
+	FRWScopeLock lock(ConnectivityLock, SLT_Write);
+
+	Connectivity = MoveTemp(connectivity);
 }
 
-void ADonNavigationManager::BeginPlay()
+void ADonNavigationManager::ReconcileConnectivityWithSamples(const FIntVector& Min, int32 Size)
 {
-	Super::BeginPlay();
+	const FIntVector max(FMath::Min(Min.X + Size, XGridSize), FMath::Min(Min.Y + Size, YGridSize), FMath::Min(Min.Z + Size, ZGridSize));
 
-	UWorld* const World = GetWorld();
+	TArray<FIntVector, TInlineAllocator<8>> voxelsOpened;
+	{
+		FRWScopeLock lock(ConnectivityLock, SLT_ReadOnly);
 
-	if (!World)
-		return;
+		for (int32 z = Min.Z; z < max.Z; z++)
+			for (int32 y = Min.Y; y < max.Y; y++)
+				for (int32 x = Min.X; x < max.X; x++)
+				{
+					const FIntVector voxel(x, y, z);
+					auto& volume = VolumeAtUnsafe(x, y, z);
 
-	//Setup common collision parameters:
-	VoxelCollisionShape = FCollisionShape::MakeBox(NavVolumeExtent());
+					if (volume.bIsInitialized && volume.CanNavigate() && !Connectivity.IsLabeledNavigable(voxel))
+						voxelsOpened.Add(voxel);
+				}
+	}
 
-	VoxelCollisionQueryParams = FCollisionQueryParams(FName("DonCollisionQuery", false)); // trace complex = false	
-	VoxelCollisionQueryParams.AddIgnoredActors(ActorsToIgnoreForCollision);	
+	if (!voxelsOpened.Num())
+		return;
 
-	VoxelCollisionQueryParams2 = FCollisionQueryParams(VoxelCollisionQueryParams);
-	VoxelCollisionQueryParams2.bFindInitialOverlaps = false;
+	FRWScopeLock lock(ConnectivityLock, SLT_Write);
 
-	for (auto collisionChannel : ObstacleQueryChannels)
-		VoxelCollisionObjectParams.AddObjectTypesToQuery(collisionChannel);
+	for (const FIntVector& voxel : voxelsOpened)
+		Connectivity.MarkNavigable(voxel);
+}
 
-	// Misc:
-	VoxelSizeSquared = VoxelSize * VoxelSize;
+void ADonNavigationManager::BuildHierarchicalGraph()
+{
+	const FIntVector gridSize(XGridSize, YGridSize, ZGridSize);
 
-	// Generate the world:
-	ConstructBuilder();
+	FRWScopeLock lock(HierarchicalGraphLock, SLT_Write);
 
-	ActiveDynamicCollisionTasks.Reserve(60);
+	// The baked bits are as good as sampled voxels and far cheaper to read. Without them, each cluster is sampled the first time a corridor reaches it:
+	if (BakedNavigationGrid.IsLoaded())
+		HierarchicalGraph.Build(gridSize, HierarchicalClusterSize, [this](const FIntVector& Voxel) { return !BakedNavigationGrid.IsBlocked(Voxel.X, Voxel.Y, Voxel.Z); });
+	else
+		HierarchicalGraph.Initialize(gridSize, HierarchicalClusterSize);
+}
 
-	RefreshPerformanceSettings();
+void ADonNavigationManager::MarkHierarchicalGraphDirty(const TArray<FIntVector>& ChangedVoxels)
+{
+	FRWScopeLock lock(HierarchicalGraphLock, SLT_Write);
 
-	// Spawn dedicated worker thread:
-	if (bMultiThreadingEnabled)
-		WorkerThread = new FDonNavigationWorker(this, MaxPathSolverIterationsOnThread, MaxCollisionSolverIterationsOnThread);
+	HierarchicalGraph.MarkDirty(ChangedVoxels);
 }
 
-void ADonNavigationManager::RefreshPerformanceSettings()
+void ADonNavigationManager::FlushHierarchicalGraphUpdates()
 {
-	if (bIsUnbound)
 	{
-		// Transfer Infinite World performance settings:
-		MaxPathSolverIterationsPerTick = MaxPathSolverIterationsPerTick_Unbound;
-		MaxCollisionSolverIterationsPerTick = MaxCollisionSolverIterationsPerTick_Unbound;
-		MaxPathSolverIterationsOnThread = MaxPathSolverIterationsOnThread_Unbound;
-		MaxCollisionSolverIterationsOnThread = MaxCollisionSolverIterationsOnThread_Unbound;
+		FRWScopeLock lock(HierarchicalGraphLock, SLT_ReadOnly);
+
+		if (!HierarchicalGraph.IsDirty())
+			return;
 	}
+
+	auto isNavigable = [this](const FIntVector& Voxel) { return CanNavigate(&VolumeAtUnsafe(Voxel.X, Voxel.Y, Voxel.Z)); };
+
+	FRWScopeLock lock(HierarchicalGraphLock, SLT_Write);
+
+	HierarchicalGraph.RebuildDirty(isNavigable);
 }
 
-void ADonNavigationManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
-{	
-	if (WorkerThread)
-	{
-		WorkerThread->ShutDown();
-	}
+void ADonNavigationManager::ResolveHierarchicalCorridor(FDoNNavigationQueryData& Data)
+{
+	auto isNavigable = [this](const FIntVector& Voxel) { return CanNavigate(&VolumeAtUnsafe(Voxel.X, Voxel.Y, Voxel.Z)); };
+
+	// (the search derives the clusters it reaches on first use)
+	FRWScopeLock lock(HierarchicalGraphLock, SLT_Write);
+
+	Data.bCorridorResolved_Hierarchical = true;
+
+	// The cluster graph doesn't use the outer corners (USE_26_DOFs), so it can miss routes that squeeze through them. Search the whole grid in that case:
+	if (!HierarchicalGraph.FindCorridor(VoxelCoords(Data.OriginVolume), VoxelCoords(Data.DestinationVolume), isNavigable, Data.Corridor_Hierarchical))
+		Data.bHierarchicalQuery = false;
 }
 
-void ADonNavigationManager::OnConstruction(const FTransform& Transform)
-{	
-	Super::OnConstruction(Transform);
+bool ADonNavigationManager::IsWithinHierarchicalCorridor(const FDoNNavigationQueryData& Data, FDonNavigationVoxel* Volume) const
+{
+	// (the cluster layout never changes after the graph is built, so this needs no lock)
+	return Data.Corridor_Hierarchical.Contains(HierarchicalGraph.ClusterAt(VoxelCoords(Volume)));
+}
 
-	Debug_RecalculateWorldBounds();
+TSharedPtr<FDonIncrementalPlanner, ESPMode::ThreadSafe> ADonNavigationManager::AcquireIncrementalPlanner(AActor* Actor)
+{
+	FScopeLock lock(&IncrementalPlannersLock);
+
+	auto& planner = IncrementalPlanners.FindOrAdd(Actor);
+
+	if (!planner.IsValid())
+		planner = MakeShareable(new FDonIncrementalPlanner());
+
+	return planner;
 }
 
-#if WITH_EDITOR
-void ADonNavigationManager::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
-{	
-	UProperty* PropertyThatChanged = PropertyChangedEvent.Property;
-	FName PropertyName = PropertyThatChanged != NULL ? PropertyThatChanged->GetFName() : NAME_None;
-	
-	if (PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, bDisplayWorldBoundary))
+void ADonNavigationManager::NotifyIncrementalPlanners(const TArray<FIntVector>& VoxelsFreed, const TArray<FDonNavigationVoxel*>& VoxelsOccupied)
+{
+	FScopeLock lock(&IncrementalPlannersLock);
+
+	for (auto it = IncrementalPlanners.CreateIterator(); it; ++it)
 	{
-		Debug_RecalculateWorldBounds();
-		WorldBoundaryVisualizer->SetVisibility(bDisplayWorldBoundary);		
+		if (!it.Key().IsValid())
+		{
+			it.RemoveCurrent();
+			continue;
+		}
+
+		auto& planner = *it.Value();
+
+		for (const FIntVector& voxel : VoxelsFreed)
+			planner.NotifyVoxelChanged(voxel);
+
+		for (auto volume : VoxelsOccupied)
+			planner.NotifyVoxelChanged(VoxelCoords(volume));
 	}
-	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, bDisplayWorldBoundaryInGame))
+}
+
+void ADonNavigationManager::DiscardIncrementalSearch(AActor* Actor)
+{
+	FScopeLock lock(&IncrementalPlannersLock);
+
+	// (a query still in flight keeps its own reference until it completes)
+	IncrementalPlanners.Remove(Actor);
+}
+
+void ADonNavigationManager::BeginAnytimeRefinementPass(FDonNavigationQueryTask& Task)
+{
+	auto& data = Task.Data;
+	auto& search = *data.SearchState;
+
+	// AnytimeTimeBudget is measured from here, however long the first pass took:
+	if (data.RefinementStartTime_Anytime < 0.0)
+		data.RefinementStartTime_Anytime = FPlatformTime::Seconds();
+
+	// This pass's path is what the query settles for should time run out during the next one:
+	data.VolumeSolution_Anytime.Reset();
+	data.PathSolution_Anytime.Reset();
+
+	if (PathSolutionFromVolumeTrajectoryMap(data.OriginVolume, data.DestinationVolume, search, data.VolumeSolution_Anytime, data.PathSolution_Anytime, data.Origin, data.Destination, data.DebugParams))
 	{
-		WorldBoundaryVisualizer->SetHiddenInGame(!bDisplayWorldBoundaryInGame);
+		FScopeLock lock(&AnytimeBestPathsLock);
+
+		AnytimeBestPaths.Add(data.Actor, data.PathSolution_Anytime);
 	}
 	else
 	{
-		bool bWorldBoundsChanged = PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, VoxelSize)
-								|| PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, XGridSize)
-								|| PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, YGridSize)
-								|| PropertyName == GET_MEMBER_NAME_CHECKED(ADonNavigationManager, ZGridSize);
+		data.VolumeSolution_Anytime.Reset();
+		data.PathSolution_Anytime.Reset();
+	}
 
-		if (bWorldBoundsChanged)
-		{
-			Debug_RecalculateWorldBounds();
-		}
-	}	
+	const float weightStep = data.QueryParams.AnytimeHeuristicWeightStep;
+	data.HeuristicWeight_Anytime = weightStep > 0.f ? FMath::Max(1.f, data.HeuristicWeight_Anytime - weightStep) : 1.f;
 
-	Super::PostEditChangeProperty(PropertyChangedEvent);
-}
-#endif // WITH_EDITOR
+	UE_LOG(DoNNavigationLog, Verbose, TEXT("Anytime query for %s found a path of %d voxels, refining with heuristic weight %.2f"), *data.GetActorName(), data.VolumeSolution_Anytime.Num(), data.HeuristicWeight_Anytime);
 
-void ADonNavigationManager::ConstructBuilder()
-{
-	UWorld* const World = GetWorld();
-	if (!World)
-		return;
+	auto priorityOf = [this, &data, &search](int32 Index) { return search.GetCost(Index) + data.HeuristicWeight_Anytime * FVector::Dist(VoxelLocation(VolumeAtIndex(Index)), data.Destination); };
 
-	if (bIsUnbound)
-		return;
-	
-	uint64 timer = DoNNavigation::Debug_GetTimer();	
-	GenerateNavigationVolumePixels();
-	DoNNavigation::Debug_StopTimer(timer);
+	// ARA*: every voxel may be expanded again, the open list is re-keyed with the new weight and joined by the voxels
+	// that were reached more cheaply after being closed. The goal goes back in as well, the pass ends when it is popped again.
+	search.ClearClosed();
+	search.ReprioritizeOpen(priorityOf);
 
-	UE_LOG(DoNNavigationLog, Log, TEXT("Time spent generating %d NAV volumes: %f seconds"), XGridSize * YGridSize * ZGridSize, timer / 1000.0);
+	for (int32 index : data.Inconsistent_Anytime)
+		search.PushOpen(index, priorityOf(index));
 
-	
-	// This snippet is useful for studying and profiling behavior of the Nav Graph Cache behavior at full load. Not recommended for production.
-	/*uint64 timerNAVNetwork = DoNNavigation::Debug_GetTimer();
-	BuildNAVNetwork();
-	DoNNavigation::Debug_StopTimer(timerNAVNetwork);
-	
-	UE_LOG(DoNNavigationLog, Log, TEXT("%s"), *FString::Printf(TEXT("Time spent building NAV network: %f seconds"), timerNAVNetwork / 1000.0));*/
+	data.Inconsistent_Anytime.Reset();
+
+	const int32 destinationIndex = VoxelIndex(data.DestinationVolume);
+	search.PushOpen(destinationIndex, priorityOf(destinationIndex));
+
+	data.bGoalFound = false;
 }
 
-void ADonNavigationManager::GenerateNavigationVolumePixels()
+bool ADonNavigationManager::PreparePartialSolution(FDonNavigationQueryTask& Task)
 {
-	UWorld* const World = GetWorld();
+	auto& data = Task.Data;
 
-	if (!World)
-		return;	
+	// Only the regular voxel search tracks its closest voxel. Not having moved away from the origin is no progress either.
+	if (!data.SearchState || !data.ClosestVolume_Partial || data.ClosestVolume_Partial == data.OriginVolume)
+		return false;
 
-	float actorX = GetActorLocation().X;
-	float actorY = GetActorLocation().Y;
-	float actorZ = GetActorLocation().Z;	
+	data.VolumeSolution.Reset();
+	data.PathSolutionRaw.Reset();
 
-	NAVVolumeData.X.Reserve(XGridSize);
+	if (PathSolutionFromVolumeTrajectoryMap(data.OriginVolume, data.ClosestVolume_Partial, *data.SearchState, data.VolumeSolution, data.PathSolutionRaw, data.Origin, VoxelLocation(data.ClosestVolume_Partial), data.DebugParams))
+		return true;
 
-	for (int i = 0; i < XGridSize; i++)
-	{
-		FDonNavVoxelX XPlaneVolumes;
-		XPlaneVolumes.Y.Reserve(YGridSize);
-		
-		for (int j = 0; j < YGridSize; j++)
-		{
-			FDonNavVoxelY YPlaneVolumes;
-			YPlaneVolumes.Z.Reserve(ZGridSize);
+	data.VolumeSolution.Reset();
+	data.PathSolutionRaw.Reset();
 
-			for (int k = 0; k < ZGridSize; k++)
-			{
-				// Progress log: (this costs performance - uncomment only when necessary)
-				//FString counter = FString::Printf(TEXT("Creating NAV Volume %d,%d,%d/%d,%d,%d"), i, j, k, XGridSize, YGridSize, ZGridSize);
-				//UE_LOG(DoNNavigationLog, Log, TEXT("%s"), *counter);
-				
-				float x = i * VoxelSize + actorX + (VoxelSize / 2);
-				float y = j * VoxelSize + actorY + (VoxelSize / 2);
-				float z = k * VoxelSize + actorZ + (VoxelSize / 2);
-				FVector Location = FVector(x, y, z);
+	return false;
+}
 
-				FDonNavigationVoxel volume;
-				volume.X = i;
-				volume.Y = j;
-				volume.Z = k;
-				volume.Location = Location;
-				
-				if (PerformCollisionChecksOnStartup)
-					UpdateVoxelCollision(volume);
+void ADonNavigationManager::SettleAnytimeSearch(FDoNNavigationQueryData& Data)
+{
+	UE_LOG(DoNNavigationLog, Verbose, TEXT("Anytime query for %s ran out of time while refining with heuristic weight %.2f, settling for the previous path"), *Data.GetActorName(), Data.HeuristicWeight_Anytime);
 
-				YPlaneVolumes.AddZ(volume);				
-			}
+	Data.VolumeSolution = MoveTemp(Data.VolumeSolution_Anytime);
+	Data.PathSolutionRaw = MoveTemp(Data.PathSolution_Anytime);
 
-			XPlaneVolumes.AddY(YPlaneVolumes);
-		}
+	Data.bSolutionSettled_Anytime = true;
+	Data.bGoalFound = true;
+}
 
-		NAVVolumeData.AddX(XPlaneVolumes);
-	}	
+bool ADonNavigationManager::GetAnytimeBestPath(AActor* Actor, TArray<FVector>& OutPath)
+{
+	FScopeLock lock(&AnytimeBestPathsLock);
+
+	auto path = AnytimeBestPaths.Find(Actor);
+	if (!path)
+		return false;
+
+	OutPath = *path;
+
+	return true;
 }
 
 void ADonNavigationManager::BuildNAVNetwork()
@@ -405,17 +1626,10 @@ void ADonNavigationManager::BuildNAVNetwork()
 
 	NavGraphCache.Reserve(XGridSize * YGridSize * ZGridSize);
 
-	for (int32 i = 0; i < NAVVolumeData.X.Num(); i++)
-	{
-		for (int32 j = 0; j < NAVVolumeData.X[i].Y.Num(); j++)
-		{
-			for (int32 k = 0; k < NAVVolumeData.X[i].Y[j].Z.Num(); k++)
-			{
-				auto& volume = NAVVolumeData.X[i].Y[j].Z[k];
-				FindOrSetupNeighborsForVolume(&volume);			
-			}
-		}
-	}
+	for (int32 z = 0; z < ZGridSize; z++)
+		for (int32 y = 0; y < YGridSize; y++)
+			for (int32 x = 0; x < XGridSize; x++)
+				FindOrSetupNeighborsForVolume(&NAVVolumeData.At(x, y, z));
 }
 
 void ADonNavigationManager::UpdateVoxelCollision(FDonNavigationVoxel& Volume)
@@ -425,7 +1639,7 @@ void ADonNavigationManager::UpdateVoxelCollision(FDonNavigationVoxel& Volume)
 
 	TArray<FOverlapResult> outOverlaps;
 
-	bool const bHit = GetWorld()->OverlapMultiByObjectType(outOverlaps, Volume.Location, FQuat::Identity, VoxelCollisionObjectParams, VoxelCollisionShape, VoxelCollisionQueryParams);
+	bool const bHit = GetWorld()->OverlapMultiByObjectType(outOverlaps, VoxelLocation(&Volume), FQuat::Identity, VoxelCollisionObjectParams, VoxelCollisionShape, VoxelCollisionQueryParams);
 
 	bool CanNavigate = !outOverlaps.Num();
 	Volume.SetNavigability(CanNavigate);
@@ -542,11 +1756,13 @@ void ADonNavigationManager::AppendImplictDOFNeighborsForVolume(int32 x, int32 y,
 
 TArray<FDonNavigationVoxel*> ADonNavigationManager::FindOrSetupNeighborsForVolume(FDonNavigationVoxel* Volume)
 {
+	const FIntVector coords = VoxelCoords(Volume);
+
 	if (NavGraphCache.Contains(Volume))
 	{
 		auto neighbors = *NavGraphCache.Find(Volume); // copy by value so we don't pollute the cache implicit DOFs
 
-		AppendImplictDOFNeighborsForVolume(Volume->X, Volume->Y, Volume->Z, neighbors);
+		AppendImplictDOFNeighborsForVolume(coords.X, coords.Y, coords.Z, neighbors);
 
 		return neighbors;
 	}
@@ -554,10 +1770,10 @@ TArray<FDonNavigationVoxel*> ADonNavigationManager::FindOrSetupNeighborsForVolum
 	{
 		// Neighbors not found, Lazy loading of NAV Graph for given volume commences...
 		TArray<FDonNavigationVoxel*> neighbors;
-		DiscoverNeighborsForVolume(Volume->X, Volume->Y, Volume->Z, neighbors);
+		DiscoverNeighborsForVolume(coords.X, coords.Y, coords.Z, neighbors);
 		NavGraphCache.Add(Volume, neighbors);
 
-		AppendImplictDOFNeighborsForVolume(Volume->X, Volume->Y, Volume->Z, neighbors);
+		AppendImplictDOFNeighborsForVolume(coords.X, coords.Y, coords.Z, neighbors);
 
 		return neighbors;
 	}
@@ -616,21 +1832,55 @@ FString ADonNavigationManager::GetMeshLogIdentifier(UPrimitiveComponent* Mesh)
 
 FDonVoxelCollisionProfile ADonNavigationManager::GetVoxelCollisionProfileFromMesh(const FDonMeshIdentifier& MeshId, bool &bResultIsValid, DonVoxelProfileCache& PreferredCache, bool bIgnoreMeshOriginOccupancy /*= false*/, bool bDisableCacheUsage /*= false*/, FName CustomCacheIdentifier /*= NAME_None*/, bool bReloadCollisionCache /*= false*/, bool bUseCheapBoundsCollision /*= false*/, float BoundsScaleFactor /*= 1.f*/, bool DrawDebug /*= false*/)
 {
+	// Rotated or scaled meshes get a profile of their own for every quantized pose:
+	const FDonMeshIdentifier profileId = GetCollisionProfileId(MeshId);
+
 	// Does the collision cache have an entry for this mesh?	
-	if (!bDisableCacheUsage && !bReloadCollisionCache && PreferredCache.Contains(MeshId))
+	if (!bDisableCacheUsage && !bReloadCollisionCache && PreferredCache.Contains(profileId))
 	{
 		bResultIsValid = true;
 
-		return *PreferredCache.Find(MeshId);
+		return *PreferredCache.Find(profileId);
 	}
 	else
 	{	
-		auto collisionData = SampleVoxelCollisionForMesh(MeshId.Mesh.Get(), bResultIsValid, bIgnoreMeshOriginOccupancy, CustomCacheIdentifier, bUseCheapBoundsCollision, BoundsScaleFactor, DrawDebug);
+		FDonVoxelCollisionProfile collisionData;
+		auto mesh = MeshId.Mesh.Get();
+
+		// Profiles sampled in earlier sessions are just as good:
+		const bool bCenteredInVoxel = true;
+		const FString persistentKey = bDisableCacheUsage ? FString() : GetPersistentVoxelCollisionProfileKey(profileId, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, bUseCheapBoundsCollision, BoundsScaleFactor);
+
+		// Simple collision is rasterized directly, that's cheaper than even looking up the persistent cache:
+		if (!bUseCheapBoundsCollision && RasterizeVoxelCollisionForMesh(mesh, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, BoundsScaleFactor, collisionData))
+		{
+			bResultIsValid = true;
+		}
+		else if (!persistentKey.IsEmpty() && !bReloadCollisionCache && PersistentVoxelCollisionProfiles.Find(persistentKey, collisionData.RelativeVoxelOccupancy))
+		{
+			bResultIsValid = true;
+		}
+		// ...as is a new pose of a mesh we've already sampled:
+		else if (mesh && !bDisableCacheUsage && !bReloadCollisionCache && !bUseCheapBoundsCollision
+			  && DeriveCollisionProfileForPose(FDonSampledCollisionProfileKey(MeshId.UniqueTag, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, BoundsScaleFactor), mesh->GetComponentQuat(), mesh->GetComponentScale(), collisionData))
+		{
+			bResultIsValid = true;
+		}
+		else
+		{
+			collisionData = SampleVoxelCollisionForMesh(mesh, bResultIsValid, bIgnoreMeshOriginOccupancy, CustomCacheIdentifier, bUseCheapBoundsCollision, BoundsScaleFactor, DrawDebug);
+
+			if (bResultIsValid && !persistentKey.IsEmpty())
+				PersistentVoxelCollisionProfiles.Add(persistentKey, collisionData.RelativeVoxelOccupancy);
+
+			if (bResultIsValid && !bDisableCacheUsage && !bUseCheapBoundsCollision)
+				AddSampledCollisionProfile(FDonSampledCollisionProfileKey(MeshId.UniqueTag, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, BoundsScaleFactor), FDonSampledCollisionProfile(mesh->GetComponentQuat(), mesh->GetComponentScale(), collisionData.RelativeVoxelOccupancy));
+		}
 
 		// Add to cache:
 		if (bResultIsValid && !bDisableCacheUsage)
 		{
-			PreferredCache.Add(MeshId, collisionData);
+			PreferredCache.Add(profileId, collisionData);
 		}
 
 		return collisionData;
@@ -683,10 +1933,18 @@ FDonVoxelCollisionProfile ADonNavigationManager::SampleVoxelCollisionForMesh(UPr
 	if (!meshOriginVolume)
 		return collisionData;
 
+	const FIntVector meshOriginCoords = VoxelCoords(meshOriginVolume);
+
 	// For optimal sampling results the mesh needs to be centered in its home voxel.
+	// In-place sampling treats the voxels as if it were (without moving it), otherwise the mesh is temporarily teleported there:
 	const bool bShouldSweep = false;
 	FVector originalMeshLocation = Mesh->GetComponentLocation();	
-	Mesh->SetWorldLocation(meshOriginVolume->Location, bShouldSweep, NULL, ETeleportType::TeleportPhysics);
+
+	FTransform centeredTransform = Mesh->GetComponentTransform();
+	centeredTransform.SetLocation(VoxelLocation(meshOriginVolume));
+
+	if (!bSampleMeshCollisionInPlace)
+		Mesh->SetWorldLocation(VoxelLocation(meshOriginVolume), bShouldSweep, NULL, ETeleportType::TeleportPhysics);
 
 	// [Draw Debug] bounds visualization:
 	// *** (Uncommented by default for manageability. Enable for debugging highly intricate scenarios.) ***
@@ -709,15 +1967,19 @@ FDonVoxelCollisionProfile ADonNavigationManager::SampleVoxelCollisionForMesh(UPr
 
 				// [Draw Debug] visualize every volume sampled. 
 				// *** (Uncommented by default for manageability. Enable for debugging highly intricate scenarios.) ***
-				//if (DrawDebug) DrawDebugVoxel_Safe(GetWorld(), volumeToCheck.Location, NavVolumeExtent(), FColor::Black, true, 0, 0, DebugVoxelsLineThickness);
+				//if (DrawDebug) DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(&volumeToCheck), NavVolumeExtent(), FColor::Black, true, 0, 0, DebugVoxelsLineThickness);
 
 				bool collisionSampled = bUseCheapBoundsCollision ? true : false;
 
 				// Sample this voxel against the mesh (skipped if cheap bounds based collision is used)
-				if (!collisionSampled)
+				if (!collisionSampled && bSampleMeshCollisionInPlace)
+				{
+					collisionSampled = OverlapsMeshInPlace(Mesh, VoxelLocation(&volumeToCheck), centeredTransform);
+				}
+				else if (!collisionSampled)
 				{
 					TArray<FOverlapResult> outOverlaps;
-					bool const bHit = GetWorld()->OverlapMultiByObjectType(outOverlaps, volumeToCheck.Location, FQuat::Identity, objectParams, VoxelCollisionShape, collisionParams);
+					bool const bHit = GetWorld()->OverlapMultiByObjectType(outOverlaps, VoxelLocation(&volumeToCheck), FQuat::Identity, objectParams, VoxelCollisionShape, collisionParams);
 
 					for (const auto& overlap : outOverlaps)
 					{
@@ -735,12 +1997,12 @@ FDonVoxelCollisionProfile ADonNavigationManager::SampleVoxelCollisionForMesh(UPr
 				{
 					// Draw voxel occupancy:
 					if (DrawDebug)
-						DrawDebugVoxel_Safe(GetWorld(), volumeToCheck.Location, NavVolumeExtent(), FColor::Red, false, 0.13f, 0, DebugVoxelsLineThickness);
+						DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(&volumeToCheck), NavVolumeExtent(), FColor::Red, false, 0.13f, 0, DebugVoxelsLineThickness);
 
-					if (volumeToCheck == (*meshOriginVolume) && bIgnoreMeshOriginOccupancy)
+					if (&volumeToCheck == meshOriginVolume && bIgnoreMeshOriginOccupancy)
 						break;
 
-					FVector relativeVoxelOffset = FVector(i - meshOriginVolume->X, j - meshOriginVolume->Y, k - meshOriginVolume->Z);
+					FVector relativeVoxelOffset = FVector(i - meshOriginCoords.X, j - meshOriginCoords.Y, k - meshOriginCoords.Z);
 					collisionData.RelativeVoxelOccupancy.Add(relativeVoxelOffset);
 				}				
 			}
@@ -748,7 +2010,8 @@ FDonVoxelCollisionProfile ADonNavigationManager::SampleVoxelCollisionForMesh(UPr
 	}
 
 	// Make sure we revert the mesh back to its original location:		
-	Mesh->SetWorldLocation(originalMeshLocation, bShouldSweep, NULL, ETeleportType::TeleportPhysics);	
+	if (!bSampleMeshCollisionInPlace)
+		Mesh->SetWorldLocation(originalMeshLocation, bShouldSweep, NULL, ETeleportType::TeleportPhysics);	
 
 	return collisionData;
 
@@ -765,6 +2028,22 @@ bool ADonNavigationManager::ScheduleDynamicCollisionUpdate(UPrimitiveComponent*
 		return false;
 	}
 
+	// Infinite worlds have no occupancy to update, only cached collision tests around the obstacle's old and new bounds to forget:
+	if (bIsUnbound)
+	{
+		const FBox bounds = Mesh->Bounds.GetBox().ExpandBy(Mesh->Bounds.BoxExtent * (BoundsScaleFactor - 1.f));
+
+		if (const FBox* previousBounds = UnboundObstacleBounds.Find(Mesh))
+			InvalidateNavigationRegion(*previousBounds);
+
+		InvalidateNavigationRegion(bounds);
+		UnboundObstacleBounds.Add(Mesh, bounds);
+
+		ResultHandler.ExecuteIfBound(true);
+
+		return true;
+	}
+
 	auto meshOriginVolume = VolumeAt(Mesh->GetComponentLocation());
 
 	if (!IsMeshBoundsWithinNavigableWorld(Mesh) || !meshOriginVolume)
@@ -776,7 +2055,15 @@ bool ADonNavigationManager::ScheduleDynamicCollisionUpdate(UPrimitiveComponent*
 	
 	// Prepare task
 	auto meshId = FDonMeshIdentifier(Mesh, CustomCacheIdentifier);
-	FDonNavigationDynamicCollisionTask task(meshId, ResultHandler, *meshOriginVolume, bDisableCacheUsage, bReloadCollisionCache, bUseCheapBoundsCollision, BoundsScaleFactor, bDrawDebug);
+	FDonNavigationDynamicCollisionTask task(meshId, ResultHandler, VoxelCoords(meshOriginVolume), bDisableCacheUsage, bReloadCollisionCache, bUseCheapBoundsCollision, BoundsScaleFactor, bDrawDebug);
+
+	// Coalesced updates replace whatever request is still pending for this mesh and are processed at the next Tick (or once a pending scroll is done):
+	if ((bCoalesceDynamicCollisionUpdates || bVoxelGridScrollPending) && !bForceSynchronousExecution)
+	{
+		CoalescedCollisionUpdates.Add(Mesh, task);
+
+		return true;
+	}
 
 	if (!bReplaceExistingTask && IsDynamicCollisionTaskActive(task))
 	{
@@ -800,7 +2087,11 @@ bool ADonNavigationManager::ScheduleDynamicCollisionUpdate(UPrimitiveComponent*
 			return false;
 		}
 
-		DynamicCollisionUpdateForMesh(task.MeshId, VoxelCollisionProfile, task.bDisableCacheUsage, task.bDrawDebug);
+		{
+			FScopeLock lock(&NAVVolumeDataLock);
+
+			DynamicCollisionUpdateForMesh(task.MeshId, VoxelCollisionProfile, task.bDrawDebug);
+		}
 
 		task.ResultHandler.ExecuteIfBound(true);
 
@@ -810,7 +2101,7 @@ bool ADonNavigationManager::ScheduleDynamicCollisionUpdate(UPrimitiveComponent*
 	bool bOverallStatus;
 	const bool bNeedsToScheduleTask = PrepareDynamicCollisionTask(task, bOverallStatus);
 	if(bNeedsToScheduleTask)
-		AddDynamicCollisionTask(task);
+		DispatchDynamicCollisionTask(task);
 
 	return bOverallStatus;	
 
@@ -820,6 +2111,67 @@ bool ADonNavigationManager::ScheduleDynamicCollisionUpdate(UPrimitiveComponent*
 
 }
 
+void ADonNavigationManager::FlushCoalescedCollisionUpdates()
+{
+	for (auto it = CoalescedCollisionUpdates.CreateIterator(); it; ++it)
+	{
+		auto mesh = it.Key().Get();
+		if (!mesh)
+		{
+			it.RemoveCurrent();
+			continue;
+		}
+
+		// At most one update per mesh is in flight, the pending one waits for it (absorbing newer requests in the meantime):
+		if (IsDynamicCollisionTaskActive(it.Value()))
+			continue;
+
+		FDonNavigationDynamicCollisionTask task = it.Value();
+		it.RemoveCurrent();
+
+		// Always apply the mesh's latest transform rather than whatever it was when the update was requested:
+		auto meshOriginVolume = VolumeAt(mesh->GetComponentLocation());
+		if (!meshOriginVolume || !IsMeshBoundsWithinNavigableWorld(mesh, task.BoundsScaleFactor))
+		{
+			UE_LOG(DoNNavigationLog, Error, TEXT("Mesh %s (%s) left the navigable world before its coalesced dynamic collision update could be processed"), *GetMeshLogIdentifier(mesh), *task.MeshId.CustomCacheIdentifier.ToString());
+
+			task.ResultHandler.ExecuteIfBound(false);
+			continue;
+		}
+
+		task.MeshOriginalVolume = VoxelCoords(meshOriginVolume);
+
+		bool bOverallStatus = false;
+		if (!PrepareDynamicCollisionTask(task, bOverallStatus))
+		{
+			task.ResultHandler.ExecuteIfBound(false);
+
+			continue;
+		}
+
+		DispatchDynamicCollisionTask(task);
+	}
+}
+
+void ADonNavigationManager::DispatchDynamicCollisionTask(FDonNavigationDynamicCollisionTask& Task)
+{
+	// (only ever called with a task PrepareDynamicCollisionTask has just accepted, on the game thread)
+	Task.bPrepared = true;
+
+	// A profile that is already known just needs to be translated to the mesh's location, do that right away unless the worker is busy with the voxel grid:
+	if (Task.bCollisionProfileSamplingComplete && Task.bCollisionFetchSuccess && NAVVolumeDataLock.TryLock())
+	{
+		DynamicCollisionUpdateForMesh(Task.MeshId, Task.CollisionData, Task.bDrawDebug);
+		NAVVolumeDataLock.Unlock();
+
+		Task.ResultHandler.ExecuteIfBound(true);
+	}
+	else
+	{
+		AddDynamicCollisionTask(Task);
+	}
+}
+
 bool ADonNavigationManager::IsDynamicCollisionTaskActive(const FDonNavigationDynamicCollisionTask& Task)
 {
 	if (!bMultiThreadingEnabled)
@@ -835,17 +2187,74 @@ bool ADonNavigationManager::IsDynamicCollisionTaskActive(const FDonNavigationDyn
 bool ADonNavigationManager::PrepareDynamicCollisionTask(FDonNavigationDynamicCollisionTask& Task, bool &bOverallStatus)
 {
 	auto mesh = Task.MeshId.Mesh.Get();
-	if (!ensure(mesh))
+	if (!ensure(IsInGameThread() && mesh))
 	{
 		bOverallStatus = false;
 		return false;
 	}
 
-	if (!Task.bDisableCacheUsage && !Task.bReloadCollisionCache && VoxelCollisionProfileCache_WorkerThread.Contains(Task.MeshId))
+	// Rotated or scaled meshes get a profile of their own for every quantized pose:
+	Task.ProfileId = GetCollisionProfileId(Task.MeshId);
+	Task.MeshRotation = mesh->GetComponentQuat();
+	Task.MeshScale = mesh->GetComponentScale();
+
+	if (!Task.bDisableCacheUsage && !Task.bReloadCollisionCache)
+	{
+		FScopeLock lock(&VoxelCollisionProfileCacheLock);
+
+		if (auto cachedProfile = VoxelCollisionProfileCache_WorkerThread.Find(Task.ProfileId))
+		{
+			Task.FetchSuccess();
+
+			Task.CollisionData = *cachedProfile;
+
+			bOverallStatus = true;
+			return true;
+		}
+	}
+
+	const bool bCenteredInVoxel = false;
+	const bool bIgnoreMeshOriginOccupancy = false;
+
+	// Simple collision is rasterized right away, no sampling needed:
+	if (!Task.bUseCheapBoundsCollision && RasterizeVoxelCollisionForMesh(mesh, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, Task.BoundsScaleFactor, Task.CollisionData))
+	{
+		Task.FetchSuccess();
+
+		if (!Task.bDisableCacheUsage)
+		{
+			FScopeLock lock(&VoxelCollisionProfileCacheLock);
+
+			VoxelCollisionProfileCache_WorkerThread.Add(Task.ProfileId, Task.CollisionData);
+		}
+
+		bOverallStatus = true;
+		return true;
+	}
+
+	// Captured along with the profile id, the worker only ever uses these two to cache and persist the profile it samples:
+	if (!Task.bDisableCacheUsage && !Task.bUseCheapBoundsCollision)
+		Task.PersistentProfileKey = GetPersistentVoxelCollisionProfileKey(Task.ProfileId, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, Task.bUseCheapBoundsCollision, Task.BoundsScaleFactor);
+
+	if (!Task.PersistentProfileKey.IsEmpty() && !Task.bReloadCollisionCache && PersistentVoxelCollisionProfiles.Find(Task.PersistentProfileKey, Task.CollisionData.RelativeVoxelOccupancy))
+	{
+		Task.FetchSuccess();
+
+		bOverallStatus = true;
+		return true;
+	}
+
+	// A new pose of a mesh we've already sampled?
+	if (!Task.bDisableCacheUsage && !Task.bReloadCollisionCache && !Task.bUseCheapBoundsCollision
+	 && DeriveCollisionProfileForPose(FDonSampledCollisionProfileKey(Task.MeshId.UniqueTag, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, Task.BoundsScaleFactor), Task.MeshRotation, Task.MeshScale, Task.CollisionData))
 	{
 		Task.FetchSuccess();
 
-		Task.CollisionData = *VoxelCollisionProfileCache_WorkerThread.Find(Task.MeshId);
+		{
+			FScopeLock lock(&VoxelCollisionProfileCacheLock);
+
+			VoxelCollisionProfileCache_WorkerThread.Add(Task.ProfileId, Task.CollisionData);
+		}
 
 		bOverallStatus = true;
 		return true;
@@ -855,7 +2264,9 @@ bool ADonNavigationManager::PrepareDynamicCollisionTask(FDonNavigationDynamicCol
 	{
 		bool bResultIsValid = false;
 		const bool bIgnoreMeshOriginOccupancy = false;
-		FDonVoxelCollisionProfile VoxelCollisionProfile = GetVoxelCollisionProfileFromMesh(Task.MeshId, bResultIsValid, VoxelCollisionProfileCache_WorkerThread, bIgnoreMeshOriginOccupancy, Task.bDisableCacheUsage, Task.MeshId.CustomCacheIdentifier, Task.bReloadCollisionCache, Task.bUseCheapBoundsCollision, Task.BoundsScaleFactor, Task.bDrawDebug);
+
+		FScopeLock lock(&VoxelCollisionProfileCacheLock);
+		FDonVoxelCollisionProfile VoxelCollisionProfile = GetVoxelCollisionProfileFromMesh(Task.ProfileId, bResultIsValid, VoxelCollisionProfileCache_WorkerThread, bIgnoreMeshOriginOccupancy, Task.bDisableCacheUsage, Task.MeshId.CustomCacheIdentifier, Task.bReloadCollisionCache, Task.bUseCheapBoundsCollision, Task.BoundsScaleFactor, Task.bDrawDebug);
 
 		if (!bResultIsValid)
 		{
@@ -864,14 +2275,13 @@ bool ADonNavigationManager::PrepareDynamicCollisionTask(FDonNavigationDynamicCol
 			return false;
 		}
 
-		DynamicCollisionUpdateForMesh(Task.MeshId, VoxelCollisionProfile, Task.bDisableCacheUsage, Task.bDrawDebug);
-
-		UE_LOG(DoNNavigationLog, Verbose, TEXT("Dynamic collision updates using cheap bounds collision complete for mesh: %s (%s)"), *GetMeshLogIdentifier(mesh), *Task.MeshId.CustomCacheIdentifier.ToString());
+		// Applied by whoever owns the voxel grid (see DispatchDynamicCollisionTask), never directly from here:
+		Task.FetchSuccess();
 
-		Task.ResultHandler.ExecuteIfBound(true);
+		Task.CollisionData = VoxelCollisionProfile;
 
 		bOverallStatus = true;
-		return false; // we don't need to schedule a task (it was already solved above)
+		return true;
 	}
 	// Prepare task data:
 	else
@@ -883,6 +2293,12 @@ bool ADonNavigationManager::PrepareDynamicCollisionTask(FDonNavigationDynamicCol
 		Task.yLength = meshExtents.Y * 2 / VoxelSize + 1;
 		Task.zLength = meshExtents.Z * 2 / VoxelSize + 1;
 
+		// Capture the sampling region so that the worker never needs to read the mesh's (live) transform or bounds:
+		Task.bSampleInPlace = bSampleMeshCollisionInPlace;
+		Task.SamplingTransform = mesh->GetComponentTransform();
+		Task.SamplingMinCoords = FIntVector((mesh->Bounds.Origin - meshExtents - GetActorLocation()) / VoxelSize);
+		Task.SamplingOriginCoords = Task.MeshOriginalVolume;
+
 		// Store collision params		
 		Task.ObjectParams.AddObjectTypesToQuery(mesh->GetCollisionObjectType());
 
@@ -930,10 +2346,14 @@ void ADonNavigationManager::ReceiveAsyncCollisionTasks()
 	///////////////	
 	if (bHasNewTask)
 	{
-		bool bOverallStatus;
-		const bool bNeedsToScheduleTask = PrepareDynamicCollisionTask(task, bOverallStatus);
-		if(bNeedsToScheduleTask)
+		// Tasks are prepared on the game thread (see DispatchDynamicCollisionTask) so the worker never touches the mesh itself, it only samples or applies them:
+		if (ensure(task.bPrepared))
 			ActiveDynamicCollisionTasks.Add(task);
+		else
+		{
+			task.FetchFailure();
+			CompletedCollisionTasks.Enqueue(task);
+		}
 
 #if DEBUG_DoNAI_THREADS
 		auto owner = task.MeshId.Mesh.Get();
@@ -948,37 +2368,55 @@ void ADonNavigationManager::TickVoxelCollisionSampler(FDonNavigationDynamicColli
 	//SCOPE_CYCLE_COUNTER(STAT_DynamicCollisionSampling);
 
 	auto mesh = Task.MeshId.Mesh.Get();
-	FVector meshMinBounds = (mesh->Bounds.Origin - Task.MeshOriginalExtents);
-	FVector meshMinBoundsCoords = (meshMinBounds - GetActorLocation()) / VoxelSize;	
 
-	int32 samplerCoordsX = (int32) meshMinBoundsCoords.X + Task.i;
-	int32 samplerCoordsY = (int32) meshMinBoundsCoords.Y + Task.j;
-	int32 samplerCoordsZ = (int32) meshMinBoundsCoords.Z + Task.k;
+	if (Task.bSampleInPlace)
+	{
+		bool bIsOccupied = false;
+		if (!SampleCollisionTaskVoxel(Task, mesh, Task.i, Task.j, Task.k, bIsOccupied))
+		{
+			Task.FetchFailure();
 
-	auto volumeToCheck = VolumeAtSafe(samplerCoordsX, samplerCoordsY, samplerCoordsZ);	
-	auto currentMeshOriginVolume = VolumeAt(mesh->GetComponentLocation());
+			return;
+		}
 
-	if (!currentMeshOriginVolume || !volumeToCheck)
+		if (bIsOccupied)
+			Task.CollisionData.RelativeVoxelOccupancy.Add(FVector(Task.SamplingMinCoords + FIntVector(Task.i, Task.j, Task.k) - Task.SamplingOriginCoords));
+	}
+	else
 	{
-		Task.FetchFailure();
+		FVector meshMinBounds = (mesh->Bounds.Origin - Task.MeshOriginalExtents);
+		FVector meshMinBoundsCoords = (meshMinBounds - GetActorLocation()) / VoxelSize;	
 
-		return;
-	}	
+		int32 samplerCoordsX = (int32) meshMinBoundsCoords.X + Task.i;
+		int32 samplerCoordsY = (int32) meshMinBoundsCoords.Y + Task.j;
+		int32 samplerCoordsZ = (int32) meshMinBoundsCoords.Z + Task.k;
 
-	// Draw every volume sampled: (** Uncomment for analyzing intricate scenarios **)
-	//if (Task.bDrawDebug) DrawDebugVoxel_Safe(GetWorld(), volumeToCheck->Location, NavVolumeExtent(), FColor::Black, true, 0, 0, DebugVoxelsLineThickness);
+		auto volumeToCheck = VolumeAtSafe(samplerCoordsX, samplerCoordsY, samplerCoordsZ);	
+		auto currentMeshOriginVolume = VolumeAt(mesh->GetComponentLocation());
 
-	TArray<FOverlapResult> outOverlaps;
-	bool const bHit = GetWorld()->OverlapMultiByObjectType(outOverlaps, volumeToCheck->Location, FQuat::Identity, Task.ObjectParams, VoxelCollisionShape, Task.CollisionParams);
+		if (!currentMeshOriginVolume || !volumeToCheck)
+		{
+			Task.FetchFailure();
 
-	for (const auto& overlap : outOverlaps)
-	{
-		if (overlap.GetComponent() == mesh)
+			return;
+		}	
+
+		// Draw every volume sampled: (** Uncomment for analyzing intricate scenarios **)
+		//if (Task.bDrawDebug) DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(volumeToCheck), NavVolumeExtent(), FColor::Black, true, 0, 0, DebugVoxelsLineThickness);
+
+		TArray<FOverlapResult> outOverlaps;
+		bool const bHit = GetWorld()->OverlapMultiByObjectType(outOverlaps, VoxelLocation(volumeToCheck), FQuat::Identity, Task.ObjectParams, VoxelCollisionShape, Task.CollisionParams);
+
+		for (const auto& overlap : outOverlaps)
 		{
-			FVector relativeVoxelOffset = FVector(samplerCoordsX - currentMeshOriginVolume->X, samplerCoordsY - currentMeshOriginVolume->Y, samplerCoordsZ - currentMeshOriginVolume->Z);
-			Task.CollisionData.RelativeVoxelOccupancy.Add(relativeVoxelOffset);
+			if (overlap.GetComponent() == mesh)
+			{
+				const FIntVector meshOriginCoords = VoxelCoords(currentMeshOriginVolume);
+				FVector relativeVoxelOffset = FVector(samplerCoordsX - meshOriginCoords.X, samplerCoordsY - meshOriginCoords.Y, samplerCoordsZ - meshOriginCoords.Z);
+				Task.CollisionData.RelativeVoxelOccupancy.Add(relativeVoxelOffset);
 
-			break;
+				break;
+			}
 		}
 	}
 
@@ -998,24 +2436,106 @@ void ADonNavigationManager::TickVoxelCollisionSampler(FDonNavigationDynamicColli
 	}
 
 	if (Task.i > Task.xLength)
-	{
-		Task.FetchSuccess();
+		CompleteVoxelCollisionSampling(Task);
+}
 
-		if(!Task.bDisableCacheUsage)
-			VoxelCollisionProfileCache_WorkerThread.Add(Task.MeshId, Task.CollisionData);	
+bool ADonNavigationManager::SampleCollisionTaskVoxel(const FDonNavigationDynamicCollisionTask& Task, UPrimitiveComponent* Mesh, int32 i, int32 j, int32 k, bool& bOutIsOccupied)
+{
+	const FIntVector coords = Task.SamplingMinCoords + FIntVector(i, j, k);
 
-		if (Task.bDrawDebug)
-		{
-			// Draw bounds:  (** Uncomment for analyzing intricate scenarios **)
-			//DrawDebugVoxel_Safe(GetWorld(), mesh->Bounds.Origin, mesh->Bounds.BoxExtent, FColor::Green, true, 0, 0, 5.f); // Note-: this needs to be original bound origin for moving objects
+	if (!IsValidVolume(coords.X, coords.Y, coords.Z))
+		return false;
+
+	bOutIsOccupied = OverlapsMeshInPlace(Mesh, LocationAtId(coords.X, coords.Y, coords.Z), Task.SamplingTransform);
+
+	return true;
+}
+
+bool ADonNavigationManager::SampleCollisionTaskInParallel(FDonNavigationDynamicCollisionTask& Task)
+{
+	auto mesh = Task.MeshId.Mesh.Get();
+	const int32 numVoxels = (Task.xLength + 1) * (Task.yLength + 1) * (Task.zLength + 1);
+
+	// Only fresh in-place tasks qualify: legacy sampling reads the live mesh on every step and world overlaps are far too coarse grained to be worth spreading out
+	const bool bHasStarted = Task.i || Task.j || Task.k;
+	if (!Task.bSampleInPlace || !mesh || bHasStarted || ParallelCollisionSamplingThreshold <= 0 || numVoxels < ParallelCollisionSamplingThreshold)
+		return false;
 
-			// Draw our solution:
-			for (const auto& offset : Task.CollisionData.RelativeVoxelOccupancy)
+	// One slab per X layer, merged in order afterwards so the profile matches what sequential sampling would have produced:
+	TArray<TArray<FVector>> slabs;
+	slabs.SetNum(Task.xLength + 1);
+
+	FThreadSafeBool bOutsideWorld = false;
+
+	ParallelFor(slabs.Num(), [&](int32 i)
+	{
+		for (int32 j = 0; j <= Task.yLength && !bOutsideWorld; j++)
+		{
+			for (int32 k = 0; k <= Task.zLength; k++)
 			{
-				auto& volume = VolumeAtUnsafe(Task.MeshOriginalVolume.X + offset.X, Task.MeshOriginalVolume.Y + offset.Y, Task.MeshOriginalVolume.Z + offset.Z);
-				DrawDebugVoxel_Safe(GetWorld(), volume.Location, NavVolumeExtent(), FColor::Red, false, 0.13f, 0, DebugVoxelsLineThickness);
+				bool bIsOccupied = false;
+				if (!SampleCollisionTaskVoxel(Task, mesh, i, j, k, bIsOccupied))
+				{
+					bOutsideWorld = true;
+					return;
+				}
+
+				if (bIsOccupied)
+					slabs[i].Add(FVector(Task.SamplingMinCoords + FIntVector(i, j, k) - Task.SamplingOriginCoords));
 			}
 		}
+	});
+
+	if (bOutsideWorld)
+	{
+		Task.FetchFailure();
+
+		return true;
+	}
+
+	for (const auto& slab : slabs)
+		Task.CollisionData.RelativeVoxelOccupancy.Append(slab);
+
+	Task.i = Task.xLength + 1;
+	Task.j = Task.k = 0;
+
+	CompleteVoxelCollisionSampling(Task);
+
+	return true;
+}
+
+void ADonNavigationManager::CompleteVoxelCollisionSampling(FDonNavigationDynamicCollisionTask& Task)
+{
+	Task.FetchSuccess();
+
+	if (!Task.bDisableCacheUsage)
+	{
+		{
+			FScopeLock lock(&VoxelCollisionProfileCacheLock);
+
+			VoxelCollisionProfileCache_WorkerThread.Add(Task.ProfileId, Task.CollisionData);
+		}
+
+		// (dynamic collision tasks always sample uncentered, keeping the origin voxel, see PrepareDynamicCollisionTask)
+		const bool bCenteredInVoxel = false;
+		const bool bIgnoreMeshOriginOccupancy = false;
+		AddSampledCollisionProfile(FDonSampledCollisionProfileKey(Task.MeshId.UniqueTag, bCenteredInVoxel, bIgnoreMeshOriginOccupancy, Task.BoundsScaleFactor), FDonSampledCollisionProfile(Task.MeshRotation, Task.MeshScale, Task.CollisionData.RelativeVoxelOccupancy));
+	}
+
+	if (!Task.PersistentProfileKey.IsEmpty())
+		PersistentVoxelCollisionProfiles.Add(Task.PersistentProfileKey, Task.CollisionData.RelativeVoxelOccupancy);
+
+	if (Task.bDrawDebug)
+	{
+		// Draw bounds:  (** Uncomment for analyzing intricate scenarios **)
+		//DrawDebugVoxel_Safe(GetWorld(), mesh->Bounds.Origin, mesh->Bounds.BoxExtent, FColor::Green, true, 0, 0, 5.f); // Note-: this needs to be original bound origin for moving objects
+
+		// Draw our solution:
+		for (const auto& offset : Task.CollisionData.RelativeVoxelOccupancy)
+		{
+			auto& volume = VolumeAtUnsafe(Task.MeshOriginalVolume.X + offset.X, Task.MeshOriginalVolume.Y + offset.Y, Task.MeshOriginalVolume.Z + offset.Z);
+			DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(&volume), NavVolumeExtent(), FColor::Red, false, 0.13f, 0, DebugVoxelsLineThickness);
+		}
 	}
 }
 
@@ -1058,6 +2578,10 @@ void ADonNavigationManager::TickScheduledCollisionTasks(float DeltaSeconds, int3
 		int32 iterations = 0;
 		task.TimeTaken += DeltaSeconds;
 
+		// Large samples are finished in one go across the task graph, this only costs the worker a single iteration:
+		if (!task.bCollisionProfileSamplingComplete && SampleCollisionTaskInParallel(task))
+			iterations++;
+
 		while (!task.bCollisionProfileSamplingComplete && iterations < maxIterationsPerTask)
 		{
 			TickVoxelCollisionSampler(task);
@@ -1069,7 +2593,7 @@ void ADonNavigationManager::TickScheduledCollisionTasks(float DeltaSeconds, int3
 		{
 			if (task.MeshId.Mesh.IsValid() && task.bCollisionFetchSuccess)
 			{
-				DynamicCollisionUpdateForMesh(task.MeshId, task.CollisionData, task.bDisableCacheUsage, task.bDrawDebug);
+				DynamicCollisionUpdateForMesh(task.MeshId, task.CollisionData, task.bDrawDebug);
 
 				UE_LOG(DoNNavigationLog, Verbose, TEXT("Dynamic collision updates complete for mesh: %s (%s) in %f seconds"), *task.MeshAssetName, *task.MeshId.UniqueTag.ToString(), task.TimeTaken);
 				
@@ -1130,7 +2654,7 @@ void ADonNavigationManager::CompleteCollisionTask(const int32 TaskIndex, bool bI
 	
 }
 
-void ADonNavigationManager::DynamicCollisionUpdateForMesh(const FDonMeshIdentifier& MeshId, FDonVoxelCollisionProfile& VoxelCollisionProfile, bool bDisableCacheUsage/* = false*/, bool bDrawDebug/* = false*/)
+void ADonNavigationManager::DynamicCollisionUpdateForMesh(const FDonMeshIdentifier& MeshId, const FDonVoxelCollisionProfile& VoxelCollisionProfile, bool bDrawDebug/* = false*/)
 {	
 	//SCOPE_CYCLE_COUNTER(STAT_DynamicCollisionUpdates);
 	
@@ -1155,65 +2679,146 @@ void ADonNavigationManager::DynamicCollisionUpdateForMesh(const FDonMeshIdentifi
 		return;
 	}
 	
-	// Note: Combining both loops (O(N2)) into a single loop possibly backed by a TSet for quick lookup of WorldVoxelsOccupied may boost performance. Profiling verification necessary.
+	// Only the voxels the mesh entered or left since its last update are touched. Slow moving obstacles thus cost O(surface delta) rather than O(volume)
+	// and only trigger repaths where they actually advance. (Voxels the mesh keeps occupying were broadcast when it first entered them, unless listened to since)
 
 	const int32 numVoxels = VoxelCollisionProfile.RelativeVoxelOccupancy.Num();
+	const FIntVector meshOriginCoords = VoxelCoords(meshOriginVolume);
 
-	// Flush out occupancy from previously occupied voxels:
-	for (auto volume : VoxelCollisionProfile.WorldVoxelsOccupied)
-	{
-		if(volume)
-			volume->SetNavigability(true);
+	auto& worldVoxelsOccupied = DynamicObstacleVoxels.FindOrAdd(MeshId.Mesh);
 
-		// Draw free'd voxels //if (bDrawDebug) DrawDebugVoxel_Safe(GetWorld(), volume->Location, NavVolumeExtent(), FColor::Green, true, 0, 0, DebugVoxelsLineThickness);
-	}	
+	TSet<FDonNavigationVoxel*> voxelsOccupiedNow;
+	voxelsOccupiedNow.Reserve(numVoxels);
+
+	for (const auto& offset : VoxelCollisionProfile.RelativeVoxelOccupancy)
+	{
+		auto volume = VolumeAtSafe(meshOriginCoords.X + offset.X, meshOriginCoords.Y + offset.Y, meshOriginCoords.Z + offset.Z);
+		if (volume)
+			voxelsOccupiedNow.Add(volume);
+	}
 
-	VoxelCollisionProfile.WorldVoxelsOccupied.Empty(numVoxels);
+	// Voxels the mesh has left, for the hierarchical graph, connectivity and retained search trees:
+	TArray<FIntVector> voxelsFreed;
 
-	TArray<FDonNavigationVoxel*> newSpaceOccupied;
-	newSpaceOccupied.Reserve(numVoxels);	
+	// Voxels whose listeners are told about this update. (Only ever used as a voxel index, so freed voxels may safely be evicted in the meantime)
+	TArray<FDonNavigationVoxel*> voxelsToBroadcast;
 
-	// and move onto occupy the newly visited voxels:
-	for (const auto& offset : VoxelCollisionProfile.RelativeVoxelOccupancy)
+	// Flush out occupancy from voxels the mesh has left:
+	for (auto volume : worldVoxelsOccupied)
 	{
-		auto volume = VolumeAtSafe(meshOriginVolume->X + offset.X, meshOriginVolume->Y + offset.Y, meshOriginVolume->Z + offset.Z);
-		if (!volume)
+		if (!volume || voxelsOccupiedNow.Contains(volume))
 			continue;
 
-		auto bPreviouslyNavigable = volume->CanNavigate();
+		voxelsFreed.Add(VoxelCoords(volume));
+		voxelsToBroadcast.Add(volume);
+
+		// (go through the grid rather than dereferencing directly in case the brick was evicted since)
+		NAVVolumeData.AtIndex(VoxelIndex(volume)).SetNavigability(true);
+		NAVVolumeData.Unpin(volume);
+
+		// Draw free'd voxels //if (bDrawDebug) DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(volume), NavVolumeExtent(), FColor::Green, true, 0, 0, DebugVoxelsLineThickness);
+	}
+
+	// and move onto occupy the newly entered voxels:
+	TArray<FDonNavigationVoxel*> newSpaceOccupied;
+	newSpaceOccupied.Reserve(numVoxels);
 
-		volume->SetNavigability(false);
-		VoxelCollisionProfile.WorldVoxelsOccupied.Add(volume);
+	TArray<FDonNavigationVoxel*> voxelsKept;
 
-		// For reasons that I don't yet understand, using bPreviouslyNavigable to optimize the number of delegates we check for doesn't work 100% right.
-		// There are edge cases where it causes us to miss out on valuable dynamic collision udpates that we truly need to listen to. 
-		// For now I'm commenting it out as both are logically equivalent; filtering _is_ more efficient though.
-		//if (bPreviouslyNavigable)
+	for (auto volume : voxelsOccupiedNow)
+	{
+		if (!worldVoxelsOccupied.Contains(volume))
 		{
+			volume->SetNavigability(false);
+			NAVVolumeData.Pin(volume);
+
 			newSpaceOccupied.Add(volume); // We don't broadcast directly from here anymore to account for potential side-effects introduced by the delegate owner
 		}
+		else
+		{
+			voxelsKept.Add(volume);
+		}
 
 		// Draw occupied voxels
 		if (bDrawDebug)
-			DrawDebugVoxel_Safe(GetWorld(), volume->Location, NavVolumeExtent(), FColor::Red, false, 0.13f, 0, DebugVoxelsLineThickness);
+			DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(volume), NavVolumeExtent(), FColor::Red, false, 0.13f, 0, DebugVoxelsLineThickness);
+	}
+
+	worldVoxelsOccupied = MoveTemp(voxelsOccupiedNow);
+
+	// Large octree leaves are assumed to be free, so split them down to the voxels we just occupied. From here on the voxel grid owns their navigability.
+	// (Leaves are never merged back when the mesh moves away, the octree simply stays a little finer around dynamic obstacles)
+	if (SparseVoxelOctree.IsValid() && newSpaceOccupied.Num())
+	{
+		FRWScopeLock lock(SparseVoxelOctreeLock, SLT_Write);
+
+		for (auto volume : newSpaceOccupied)
+			SparseVoxelOctree.SplitToVoxel(VoxelCoords(volume));
+	}
+
+	// Only the clusters the mesh entered or left (and those sharing a face with them) are re-derived, by the solver before it next searches:
+	if (HierarchicalGraph.IsValid())
+	{
+		TArray<FIntVector> voxelsChanged = voxelsFreed;
+
+		for (auto volume : newSpaceOccupied)
+			voxelsChanged.Add(VoxelCoords(volume));
+
+		if (voxelsChanged.Num())
+			MarkHierarchicalGraphDirty(voxelsChanged);
+	}
+
+	// Occupied voxels leave their component, freed ones join (and possibly merge) the components around them:
+	if (Connectivity.IsValid() && (voxelsFreed.Num() || newSpaceOccupied.Num()))
+	{
+		FRWScopeLock lock(ConnectivityLock, SLT_Write);
+
+		for (auto volume : newSpaceOccupied)
+			Connectivity.MarkBlocked(VoxelCoords(volume));
+
+		for (const FIntVector& voxel : voxelsFreed)
+			Connectivity.MarkNavigable(voxel);
+	}
+
+	// Retained search trees are repaired around these voxels the next time their actors repath:
+	if (voxelsFreed.Num() || newSpaceOccupied.Num())
+		NotifyIncrementalPlanners(voxelsFreed, newSpaceOccupied);
+
+	voxelsToBroadcast.Append(newSpaceOccupied);
+
+	// Paths may have been planned through voxels the mesh kept occupying before its occupancy reached the solver. Their listeners are told as well:
+	{
+		FScopeLock lock(&VoxelCollisionNotifyeesLock);
+
+		uint32& listenerSerial = DynamicObstacleListenerSerials.FindOrAdd(MeshId.Mesh);
+
+		if (listenerSerial != CollisionListenerSerial)
+		{
+			const uint32 lastUpdateSerial = listenerSerial;
+
+			for (auto volume : voxelsKept)
+			{
+				auto notifyees = VoxelCollisionNotifyees.Find(VoxelIndex(volume));
+
+				if (notifyees && notifyees->ContainsByPredicate([lastUpdateSerial](const FDonNavigationDynamicCollisionNotifyee& notifyee) { return notifyee.RegisteredAt > lastUpdateSerial; }))
+					voxelsToBroadcast.Add(volume);
+			}
+
+			listenerSerial = CollisionListenerSerial;
+		}
 	}
 
 	// Broadcast dynamic collision updates!
 	if (!bMultiThreadingEnabled)
 	{
-		for (auto volume : newSpaceOccupied)
-			volume->BroadcastCollisionUpdates();
+		for (auto volume : voxelsToBroadcast)
+			BroadcastCollisionUpdates(volume);
 	}
 	else
 	{
-		for (auto volume : newSpaceOccupied)
+		for (auto volume : voxelsToBroadcast)
 			DynamicCollisionBroadcastQueue.Enqueue(volume);
 	}
-	
-
-	// Update the cache with latest occupany data:
-	if(!bDisableCacheUsage)
-		VoxelCollisionProfileCache_WorkerThread.Add(MeshId, VoxelCollisionProfile);
 }
 
 void ADonNavigationManager::Debug_ToggleWorldBoundaryInGame()
@@ -1251,11 +2856,13 @@ void ADonNavigationManager::Debug_DrawVolumesAroundPoint(FVector Location, int32
 	if (!volume)
 		return;
 
-	for (int i = volume->X - CubeSize / 2; i < volume->X + CubeSize / 2; i++)
+	const FIntVector coords = VoxelCoords(volume);
+
+	for (int i = coords.X - CubeSize / 2; i < coords.X + CubeSize / 2; i++)
 	{
-		for (int j = volume->Y - CubeSize / 2; j < volume->Y + CubeSize / 2; j++)
+		for (int j = coords.Y - CubeSize / 2; j < coords.Y + CubeSize / 2; j++)
 		{
-			for (int k = volume->Z - CubeSize / 2; k < volume->Z + CubeSize / 2; k++)
+			for (int k = coords.Z - CubeSize / 2; k < coords.Z + CubeSize / 2; k++)
 			{
 				if (IsValidVolume(i, j, k))
 				{
@@ -1269,7 +2876,7 @@ void ADonNavigationManager::Debug_DrawVolumesAroundPoint(FVector Location, int32
 					FColor color = canNavigate ? FColor::Green : FColor::Red;
 					float lineThickness = canNavigate ? LineThickness : LineThickness / 2;
 					FVector extents = canNavigate ? NavVolumeExtent() : NavVolumeExtent() * 0.95f;
-					DrawDebugVoxel_Safe(GetWorld(), volumeToRender.Location, extents, color, DrawPersistentLines, 0, Duration, DebugVoxelsLineThickness);
+					DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(&volumeToRender), extents, color, DrawPersistentLines, 0, Duration, DebugVoxelsLineThickness);
 				}
 			}
 		}
@@ -1295,17 +2902,21 @@ void ADonNavigationManager::Debug_DrawVoxelCollisionProfile(UPrimitiveComponent*
 	// ~~~
 	// Step 1. Draw the "center" voxel of the mesh
 	FVector centerVoxel;
-	FDonNavigationVoxel* meshOriginVolume = NULL;
+	FIntVector meshOriginCoords;
 
 	if (bIsUnbound)
+	{
 		centerVoxel = VolumeOriginAt(MeshOrPrimitive->GetComponentLocation());
+		meshOriginCoords = FIntVector(VolumeIdAt(MeshOrPrimitive->GetComponentLocation()));
+	}
 	else
 	{
-		meshOriginVolume = VolumeAt(MeshOrPrimitive->GetComponentLocation());
+		auto meshOriginVolume = VolumeAt(MeshOrPrimitive->GetComponentLocation());
 		if (!meshOriginVolume)
 			return;
 
-		centerVoxel = meshOriginVolume->Location;
+		centerVoxel = VoxelLocation(meshOriginVolume);
+		meshOriginCoords = VoxelCoords(meshOriginVolume);
 	}
 
 	// The navigation solver always assumes the origin voxel to occupy space, so should we:
@@ -1318,9 +2929,9 @@ void ADonNavigationManager::Debug_DrawVoxelCollisionProfile(UPrimitiveComponent*
 	// Step 2. Draw all the other voxels (for meshes which are using a full-blown voxel profile representation)
 	for (auto offset : voxelCollisionProfile.RelativeVoxelOccupancy)
 	{
-		const int32 voxelX = meshOriginVolume->X + offset.X;
-		const int32 voxelY = meshOriginVolume->Y + offset.Y;
-		const int32 voxelZ = meshOriginVolume->Z + offset.Z;
+		const int32 voxelX = meshOriginCoords.X + offset.X;
+		const int32 voxelY = meshOriginCoords.Y + offset.Y;
+		const int32 voxelZ = meshOriginCoords.Z + offset.Z;
 
 		FVector voxelLocation;
 		if (bIsUnbound)
@@ -1332,7 +2943,7 @@ void ADonNavigationManager::Debug_DrawVoxelCollisionProfile(UPrimitiveComponent*
 			if (!volume)
 				continue;
 
-			voxelLocation = volume->Location;
+			voxelLocation = VoxelLocation(volume);
 		}
 
 		DrawDebugVoxel_Safe(GetWorld(), voxelLocation, NavVolumeExtent(), FColor::Red, bDrawPersistent, Duration, 0, DebugVoxelsLineThickness);
@@ -1509,12 +3120,12 @@ void ADonNavigationManager::PathSolutionFromVolumeSolution(const TArray<FDonNavi
 	PathSolution.Add(Origin);
 
 	for (auto volume : VolumeSolution)
-		PathSolution.Add(volume->Location);
+		PathSolution.Add(VoxelLocation(volume));
 
 	PathSolution.Add(Destination);
 }
 
-static bool PathSolutionFromVolumeTrajectoryMap(FDonNavigationVoxel* OriginVolume, FDonNavigationVoxel* DestinationVolume, const TMap<FDonNavigationVoxel*, FDonNavigationVoxel*>& VolumeVsGoalTrajectoryMap, TArray<FDonNavigationVoxel*>& VolumeSolution, TArray<FVector> &PathSolution, FVector Origin, FVector Destination, const FDoNNavigationDebugParams& DebugParams)
+bool ADonNavigationManager::PathSolutionFromVolumeTrajectoryMap(FDonNavigationVoxel* OriginVolume, FDonNavigationVoxel* DestinationVolume, const FDonNavigationSearchState& SearchState, TArray<FDonNavigationVoxel*>& VolumeSolution, TArray<FVector> &PathSolution, FVector Origin, FVector Destination, const FDoNNavigationDebugParams& DebugParams)
 {	
 	// a rare edgecase, but worth handling gracefully in any case
 	if (OriginVolume == DestinationVolume) 
@@ -1534,23 +3145,23 @@ static bool PathSolutionFromVolumeTrajectoryMap(FDonNavigationVoxel* OriginVolum
 
 	// Work our way back from destination to origin while generating a linear path solution list
 	bool originFound = false;
-	auto nextVolume = VolumeVsGoalTrajectoryMap.Find(DestinationVolume);
+	auto nextVolume = VolumeAtIndex(SearchState.GetParent(VoxelIndex(DestinationVolume)));
 
 	while (nextVolume)
 	{
-		if (VolumeSolution.Contains(*nextVolume))
+		if (VolumeSolution.Contains(nextVolume))
 			break;
 
-		VolumeSolution.Insert(*nextVolume, 0);
-		PathSolution.Insert((*nextVolume)->Location, 0);
+		VolumeSolution.Insert(nextVolume, 0);
+		PathSolution.Insert(VoxelLocation(nextVolume), 0);
 
-		if (*nextVolume == OriginVolume)
+		if (nextVolume == OriginVolume)
 		{
 			originFound = true;
 			break;
 		}
 
-		nextVolume = VolumeVsGoalTrajectoryMap.Find(*nextVolume);
+		nextVolume = VolumeAtIndex(SearchState.GetParent(VoxelIndex(nextVolume)));
 	}
 
 	return originFound;
@@ -1572,7 +3183,7 @@ FDonNavigationVoxel* ADonNavigationManager::GetBestNeighborRecursive(FDonNavigat
 
 		if (!bShouldSweep)
 			return neighbor;
-		else if (IsDirectPathLineSweep(CollisionComponent, Location, neighbor->Location, hit, bConsiderInitialOverlaps, CollisionShapeInflation))
+		else if (IsDirectPathLineSweep(CollisionComponent, Location, VoxelLocation(neighbor), hit, bConsiderInitialOverlaps, CollisionShapeInflation))
 			return neighbor;
 	}
 
@@ -1644,6 +3255,7 @@ FDonNavigationVoxel* ADonNavigationManager::GetClosestNavigableVolume(FVector Lo
 	}
 
 	// 2 a) First we start with simple heuristics based checks for the closest accessible neighbor:
+	const FIntVector coords = VoxelCoords(volume);
 	static const int32 neighborGuessList = 9;
 	static const int32 expansionStepSize = 2;
 	static const int32 numIterations = 2;
@@ -1657,12 +3269,12 @@ FDonNavigationVoxel* ADonNavigationManager::GetClosestNavigableVolume(FVector Lo
 		for (int32 i = 0; i < neighborGuessList; i++)
 		{
 			int32 stepScale = step * expansionStepSize;
-			auto volumeGuess = VolumeAtSafe(volume->X + xGuessList[i], volume->Y + yGuessList[i], volume->Z + zGuessList[i] * stepScale);
+			auto volumeGuess = VolumeAtSafe(coords.X + xGuessList[i], coords.Y + yGuessList[i], coords.Z + zGuessList[i] * stepScale);
 			if (volumeGuess && CanNavigate(volumeGuess))
 			{
 				if (!bShouldSweep)
 					return volumeGuess;
-				else if (IsDirectPathLineSweep(CollisionComponent, Location, volumeGuess->Location, hit, bConsiderInitialOverlaps, CollisionShapeInflation))
+				else if (IsDirectPathLineSweep(CollisionComponent, Location, VoxelLocation(volumeGuess), hit, bConsiderInitialOverlaps, CollisionShapeInflation))
 					return volumeGuess;
 			}
 		}
@@ -1879,7 +3491,7 @@ bool ADonNavigationManager::CanNavigate(FVector Location)
 bool ADonNavigationManager::CanNavigate(FDonNavigationVoxel* Volume)
 {
 	if (!Volume->bIsInitialized)
-		UpdateVoxelCollision(*Volume);
+		InitializeVoxel(*Volume);
 
 	return Volume->CanNavigate();
 }
@@ -1901,31 +3513,66 @@ bool ADonNavigationManager::CanNavigateByCollisionProfile(FDonNavigationVoxel* V
 	return bCanNavigate;
 }
 
-bool ADonNavigationManager::CanNavigateByCollisionProfile(FVector Location, const FDonVoxelCollisionProfile& CollisionToTest)
+bool ADonNavigationManager::CanNavigateByCollisionProfile(const FIntVector& Voxel, const FDonVoxelCollisionProfile& CollisionToTest)
 {
-	if (!CanNavigate(Location))
+	if (!CanNavigateVoxelAt(Voxel))
 		return false;
 
 	bool bCanNavigate = true;
 
 	for (FVector voxelOffset : CollisionToTest.RelativeVoxelOccupancy)
 	{
-		FVector locationToTest = LocationAtId(Location, voxelOffset.X, voxelOffset.Y, voxelOffset.Z);
-
-		if (!CanNavigate(locationToTest))
+		if (!CanNavigateVoxelAt(Voxel + FIntVector(voxelOffset)))
 			return false;
 	}
 
 	return bCanNavigate;
 }
 
+bool ADonNavigationManager::CanNavigateVoxelAt(const FIntVector& Voxel)
+{
+	if (!bCacheUnboundVoxelOccupancy)
+		return CanNavigate(LocationAtId(Voxel.X, Voxel.Y, Voxel.Z));
+
+	const uint32 epoch = UnboundOccupancyCache.GetInvalidationEpoch();
+
+	bool bIsBlocked = false;
+	if (UnboundOccupancyCache.Find(Voxel, bIsBlocked))
+		return !bIsBlocked;
+
+	const bool bCanNavigate = CanNavigate(LocationAtId(Voxel.X, Voxel.Y, Voxel.Z));
+	UnboundOccupancyCache.Add(Voxel, !bCanNavigate, epoch);
+
+	return bCanNavigate;
+}
+
+void ADonNavigationManager::InvalidateNavigationRegion(const FBox& Region)
+{
+	if (!Region.IsValid)
+		return;
+
+	// (voxels are tested with a box as large as the voxel itself, so anything within the region's bounds can affect them)
+	const FIntVector min = FIntVector(VolumeIdAt(Region.Min));
+	const FIntVector max = FIntVector(VolumeIdAt(Region.Max));
+
+	UnboundOccupancyCache.InvalidateRegion(min, max);
+}
+
 void ADonNavigationManager::ExpandFrontierTowardsTarget(FDonNavigationQueryTask& Task, FDonNavigationVoxel* Current, FDonNavigationVoxel* Neighbor)
 {
 	auto& data = Task.Data;
-	if (!CanNavigateByCollisionProfile(Neighbor, data.VoxelCollisionProfile))
+	auto& search = *data.SearchState;
+	const int32 neighborIndex = VoxelIndex(Neighbor);
+
+	// (anytime search tracks closed voxels that turn out cheaper, see BeginAnytimeRefinementPass)
+	const bool bNeighborClosed = search.IsClosed(neighborIndex);
+	if (bNeighborClosed && !data.bAnytimeQuery)
+		return;
+
+	if (data.bHierarchicalQuery && !IsWithinHierarchicalCorridor(data, Neighbor))
 		return;
 
-	if (data.VolumeClosedList.Find(Neighbor))
+	if (!CanNavigateByCollisionProfile(Neighbor, data.VoxelCollisionProfile))
 		return;
 
 	auto current = Current;
@@ -1947,25 +3594,157 @@ void ADonNavigationManager::ExpandFrontierTowardsTarget(FDonNavigationQueryTask&
 #if OPTIMIZE_SEGMENT
 	float SegmentDist = VoxelSize;
 #else
-	float SegmentDist = VoxelSize * FDonNavigationVoxel::DistanceL2(*current, *Neighbor);
+	float SegmentDist = VoxelSize * VoxelDistanceL2(VoxelCoords(current), VoxelCoords(Neighbor));
 #endif
 
-	auto newCost = *data.VolumeVsCostMap.Find(current) + SegmentDist;
-	auto* volumeCost = data.VolumeVsCostMap.Find(Neighbor);
+	auto newCost = search.GetCost(VoxelIndex(current)) + SegmentDist;
+
+	// (unreached voxels cost MAX_flt)
+	if (newCost < search.GetCost(neighborIndex))
+	{
+		search.Visit(neighborIndex, newCost, VoxelIndex(current));
+
+		if (bNeighborClosed)
+		{
+			data.Inconsistent_Anytime.Add(neighborIndex);
+			return;
+		}
+
+		auto heuristic = FVector::Dist(VoxelLocation(Neighbor), data.Destination);
+		auto priority = newCost + data.HeuristicWeight_Anytime * heuristic;
+
+		search.PushOpen(neighborIndex, priority);
+		if (data.DebugParams.DrawDebugOpenListVolumes)
+		{
+			// Hang & Lowell : draw open list
+			DrawDebugPoint_Safe(GetWorld(), VoxelLocation(Neighbor), 6.f, FColor::Magenta, true, -1.f);
+		}
+	}
+}
+
+bool ADonNavigationManager::CanJumpThrough(const FIntVector& Coords, const FDonVoxelCollisionProfile& CollisionProfile)
+{
+	auto volume = VolumeAtSafe(Coords.X, Coords.Y, Coords.Z);
+
+	return volume && CanNavigateByCollisionProfile(volume, CollisionProfile);
+}
+
+uint8 ADonNavigationManager::JumpPointRingMask(const FIntVector& Coords, const FIntVector& AxisU, const FIntVector& AxisV, const FDonVoxelCollisionProfile& CollisionProfile)
+{
+	const FIntVector ring[8] = { AxisU, AxisU * -1, AxisV, AxisV * -1, AxisU + AxisV, AxisU - AxisV, AxisV - AxisU, (AxisU + AxisV) * -1 };
+
+	uint8 mask = 0;
+
+	for (int32 i = 0; i < 8; i++)
+	{
+		if (CanJumpThrough(Coords + ring[i], CollisionProfile))
+			mask |= 1 << i;
+	}
+
+	return mask;
+}
+
+FDonNavigationVoxel* ADonNavigationManager::JumpStraight(FDonNavigationQueryTask& Task, const FIntVector& From, const FIntVector& Direction)
+{
+	auto& data = Task.Data;
+	const auto& collisionProfile = data.VoxelCollisionProfile;
+	const FIntVector destination = VoxelCoords(data.DestinationVolume);
+
+	// The two axes spanning the plane perpendicular to the jump:
+	const FIntVector axisU = Direction.X != 0 ? FIntVector(0, 1, 0) : FIntVector(1, 0, 0);
+	const FIntVector axisV = Direction.Z != 0 ? FIntVector(0, 1, 0) : FIntVector(0, 0, 1);
+
+	uint8 previousRing = JumpPointRingMask(From, axisU, axisV, collisionProfile);
+
+	for (int32 scanLength = 1; ; scanLength++)
+	{
+		const FIntVector current = From + Direction * scanLength;
+
+		data.SolverIterationsCharged++;
+
+		if (!CanJumpThrough(current, collisionProfile))
+			return NULL;
+
+		// The goal, or as far as a single jump may scan (the search resumes from there when it's expanded):
+		if (current == destination || scanLength >= MaxJumpPointScanLength)
+			return &VolumeAtUnsafe(current.X, current.Y, current.Z);
+
+		// A voxel beside the line that was blocked one step back is now open. Routes branching off here can't be reproduced from
+		// the jump's origin at the same cost, so this becomes a jump point:
+		const uint8 ring = JumpPointRingMask(current, axisU, axisV, collisionProfile);
+		if (ring & ~previousRing)
+			return &VolumeAtUnsafe(current.X, current.Y, current.Z);
+
+		previousRing = ring;
+	}
+}
+
+void ADonNavigationManager::ExpandFrontierByJump(FDonNavigationQueryTask& Task, FDonNavigationVoxel* Current, FDonNavigationVoxel* JumpPoint)
+{
+	auto& data = Task.Data;
+	auto& search = *data.SearchState;
+	const int32 jumpPointIndex = VoxelIndex(JumpPoint);
+
+	const bool bJumpPointClosed = search.IsClosed(jumpPointIndex);
+	if (bJumpPointClosed && !data.bAnytimeQuery)
+		return;
+
+	if (data.bHierarchicalQuery && !IsWithinHierarchicalCorridor(data, JumpPoint))
+		return;
+
+	// Jumps span many voxels, so unlike ExpandFrontierTowardsTarget segments are always measured (OPTIMIZE_SEGMENT doesn't apply)
+	auto newCost = search.GetCost(VoxelIndex(Current)) + VoxelSize * VoxelDistanceL2(VoxelCoords(Current), VoxelCoords(JumpPoint));
+
+	if (newCost < search.GetCost(jumpPointIndex))
+	{
+		search.Visit(jumpPointIndex, newCost, VoxelIndex(Current));
+
+		if (bJumpPointClosed)
+		{
+			data.Inconsistent_Anytime.Add(jumpPointIndex);
+			return;
+		}
+
+		auto heuristic = FVector::Dist(VoxelLocation(JumpPoint), data.Destination);
+		auto priority = newCost + data.HeuristicWeight_Anytime * heuristic;
+
+		search.PushOpen(jumpPointIndex, priority);
+
+		if (data.DebugParams.DrawDebugOpenListVolumes)
+			DrawDebugPoint_Safe(GetWorld(), VoxelLocation(JumpPoint), 6.f, FColor::Magenta, true, -1.f);
+	}
+}
+
+void ADonNavigationManager::ExpandJumpPointSuccessors(FDonNavigationQueryTask& Task, FDonNavigationVoxel* Current)
+{
+	const auto& collisionProfile = Task.Data.VoxelCollisionProfile;
+	const FIntVector coords = VoxelCoords(Current);
 
-	if (!volumeCost || newCost < *volumeCost)
+	// 6 DOF: jump
+	for (int32 i = 0; i < Volume6DOF; i++)
 	{
-		data.VolumeVsGoalTrajectoryMap.Add(Neighbor, current);
-		data.VolumeVsCostMap.Add(Neighbor, newCost);
+		const FIntVector direction(x6DOFCoords[i], y6DOFCoords[i], z6DOFCoords[i]);
 
-		auto heuristic = FVector::Dist(Neighbor->Location, data.Destination);
-		auto priority = newCost + heuristic;
+		if (auto jumpPoint = JumpStraight(Task, coords, direction))
+			ExpandFrontierByJump(Task, Current, jumpPoint);
+	}
 
-		data.Frontier.put(Neighbor, priority);
-		if (data.DebugParams.DrawDebugOpenListVolumes)
+	// Implicit DOF: step. Each is formed by two direct degrees of freedom along different axes, both of which must be open.
+	for (int32 i = 0; i < Volume6DOF; i++)
+	{
+		const FIntVector directionA(x6DOFCoords[i], y6DOFCoords[i], z6DOFCoords[i]);
+
+		for (int32 j = i + 1; j < Volume6DOF; j++)
 		{
-			// Hang & Lowell : draw open list
-			DrawDebugPoint_Safe(GetWorld(), Neighbor->Location, 6.f, FColor::Magenta, true, -1.f);
+			const FIntVector directionB(x6DOFCoords[j], y6DOFCoords[j], z6DOFCoords[j]);
+			const FIntVector neighbor = coords + directionA + directionB;
+
+			// (opposing directions of the same axis cancel out)
+			if (neighbor == coords)
+				continue;
+
+			if (CanJumpThrough(coords + directionA, collisionProfile) && CanJumpThrough(coords + directionB, collisionProfile) && CanJumpThrough(neighbor, collisionProfile))
+				ExpandFrontierByJump(Task, Current, &VolumeAtUnsafe(neighbor.X, neighbor.Y, neighbor.Z));
 		}
 	}
 }
@@ -2076,8 +3855,8 @@ bool ADonNavigationManager::FindPathSolution_StressTesting(AActor* Actor, FVecto
 	// Input Visualization - II
 	if (DebugParams.DrawDebugVolumes)
 	{
-		DrawDebugVoxel_Safe(GetWorld(), originVolume->Location,      NavVolumeExtent(), FColor::White, false, 0.13f, 0, DebugVoxelsLineThickness);
-		DrawDebugVoxel_Safe(GetWorld(), destinationVolume->Location, NavVolumeExtent(), FColor::Green, false, 0.13f, 0, DebugVoxelsLineThickness);
+		DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(originVolume),      NavVolumeExtent(), FColor::White, false, 0.13f, 0, DebugVoxelsLineThickness);
+		DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(destinationVolume), NavVolumeExtent(), FColor::Green, false, 0.13f, 0, DebugVoxelsLineThickness);
 	}
 
 	// Load voxel collision profile:
@@ -2088,17 +3867,19 @@ bool ADonNavigationManager::FindPathSolution_StressTesting(AActor* Actor, FVecto
 	uint64 timerPathfinding = DoNNavigation::Debug_GetTimer();
 	
 	FDonNavigationQueryTask synchronousTask = FDonNavigationQueryTask(
-		FDoNNavigationQueryData(Actor, CollisionComponent, Origin, Destination, QueryParams, DebugParams, originVolume, destinationVolume, originVolume->Location, destinationVolume->Location, voxelCollisionProfile),
+		FDoNNavigationQueryData(Actor, CollisionComponent, Origin, Destination, QueryParams, DebugParams, originVolume, destinationVolume, VoxelLocation(originVolume), VoxelLocation(destinationVolume), voxelCollisionProfile),
 		FDoNNavigationResultHandler(),
 		FDonNavigationDynamicCollisionDelegate()
 		);
 
 	auto& data = synchronousTask.Data;
 
+	BeginVoxelSearch(data);
+
 	// Core pathfinding algorithm
-	while (!data.Frontier.empty())
+	while (!data.SearchState->IsOpenListEmpty())
 	{
-		auto currentVolume = data.Frontier.get(); // the current volume is the "best neighbor" (highest priority) of the previous volume
+		auto currentVolume = VolumeAtIndex(data.SearchState->PopOpen()); // the current volume is the "best neighbor" (highest priority) of the previous volume
 
 		// Hang & Lowell : 0 - A Star, 1 - Theta Star, 2 - Lazy Theta Star
 		switch (data.QueryParams.AlgorithmType)
@@ -2116,7 +3897,13 @@ bool ADonNavigationManager::FindPathSolution_StressTesting(AActor* Actor, FVecto
 			break;
 		}
 
-		data.VolumeClosedList.Add(currentVolume);
+		data.SearchState->Close(VoxelIndex(currentVolume));
+
+		if (data.QueryParams.AlgorithmType == 3)
+		{
+			ExpandJumpPointSuccessors(synchronousTask, currentVolume);
+			continue;
+		}
 
 		const auto& neighbors = FindOrSetupNeighborsForVolume(currentVolume);
 		for (auto neighbor : neighbors)
@@ -2128,6 +3915,8 @@ bool ADonNavigationManager::FindPathSolution_StressTesting(AActor* Actor, FVecto
 	// Goal validation:
 	if (!data.bGoalFound)
 	{
+		EndVoxelSearch(data);
+
 		DoNNavigation::Debug_StopTimer(timerPathfinding);
 		UE_LOG(DoNNavigationLog, Error, TEXT("%s"), *FString::Printf(TEXT("Error: Goal not found. Time spent attempting to solve - %f seconds"), timerPathfinding / 1000.0));
 
@@ -2136,10 +3925,14 @@ bool ADonNavigationManager::FindPathSolution_StressTesting(AActor* Actor, FVecto
 
 	// Translate volume path solution to vector path solution:
 	TArray<FDonNavigationVoxel*> volumeSolution;
-	data.bGoalFound = PathSolutionFromVolumeTrajectoryMap(originVolume, destinationVolume, data.VolumeVsGoalTrajectoryMap, volumeSolution, PathSolutionRaw, Origin, Destination, DebugParams);
+	data.bGoalFound = PathSolutionFromVolumeTrajectoryMap(originVolume, destinationVolume, *data.SearchState, volumeSolution, PathSolutionRaw, Origin, Destination, DebugParams);
+	const int32 numVisited = data.SearchState->NumVisited();
+
+	EndVoxelSearch(data);
+
 	if (!data.bGoalFound)
 	{
-		UE_LOG(DoNNavigationLog, Error, TEXT("%s"), *FString::Printf(TEXT("Goal not found among %d goal trajectory nodes"), data.VolumeVsGoalTrajectoryMap.Num()));
+		UE_LOG(DoNNavigationLog, Error, TEXT("%s"), *FString::Printf(TEXT("Goal not found among %d goal trajectory nodes"), numVisited));
 
 		return false;
 	}
@@ -2175,6 +3968,15 @@ bool ADonNavigationManager::SchedulePathfindingTask(AActor* Actor, FVector Desti
 		return false;
 	}
 
+	// The grid is about to scroll, everything else (including the world bounds) is validated once it has:
+	if (bVoxelGridScrollPending)
+	{
+		HeldPathfindingQueries.RemoveAll([Actor](const FDonHeldPathfindingQuery& Query) { return Query.Actor.Get() == Actor; });
+		HeldPathfindingQueries.Add({ Actor, Destination, QueryParams, DebugParams, ResultHandlerDelegate, DynamicCollisionListener });
+
+		return true;
+	}
+
 	if (!bIsUnbound && !IsLocationWithinNavigableWorld(Destination))
 	{
 		UE_LOG(DoNNavigationLog, Error, TEXT("Destination %s is outside world bounds. Please clamp your destination within the navigable world or expand world size under settings if necessary."), *Destination.ToString());
@@ -2246,10 +4048,10 @@ bool ADonNavigationManager::SchedulePathfindingTask(AActor* Actor, FVector Desti
 		if (DebugParams.DrawDebugVolumes)
 		{
 			if(originVolume)
-				DrawDebugVoxel_Safe(GetWorld(), originVolume->Location, NavVolumeExtent(), FColor::White, false, 0.13f, 0, DebugVoxelsLineThickness);
+				DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(originVolume), NavVolumeExtent(), FColor::White, false, 0.13f, 0, DebugVoxelsLineThickness);
 
 			if(destinationVolume)
-				DrawDebugVoxel_Safe(GetWorld(), destinationVolume->Location, NavVolumeExtent(), FColor::Green, false, 0.13f, 0, DebugVoxelsLineThickness);
+				DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(destinationVolume), NavVolumeExtent(), FColor::Green, false, 0.13f, 0, DebugVoxelsLineThickness);
 		}
 	}
 	else
@@ -2266,6 +4068,27 @@ bool ADonNavigationManager::SchedulePathfindingTask(AActor* Actor, FVector Desti
 		return false;
 	}
 
+	// Unbound worlds can only search as far as voxel keys reach:
+	if (bIsUnbound && (!FDonNavigationVoxelKey::IsInRange(FIntVector(VolumeIdAt(resolvedOriginCenter))) || !FDonNavigationVoxelKey::IsInRange(FIntVector(VolumeIdAt(resolvedDestinationCenter)))))
+	{
+		UE_LOG(DoNNavigationLog, Error, TEXT("Pathfinding query for %s from %s to %s lies beyond %d voxels of the world origin, which unbound worlds can't address"), *Actor->GetName(), *Origin.ToString(), *Destination.ToString(), FDonNavigationVoxelKey::AxisBias);
+
+		return false;
+	}
+
+	// Input Validations - III
+	if (!bIsUnbound && Connectivity.IsValid())
+	{
+		FRWScopeLock lock(ConnectivityLock, SLT_ReadOnly);
+
+		if (!Connectivity.MayBeConnected(VoxelCoords(originVolume), VoxelCoords(destinationVolume)))
+		{
+			UE_LOG(DoNNavigationLog, Warning, TEXT("No pathfinding solution exists for query %s, %s: destination is not reachable from origin"), *Actor->GetName(), *Destination.ToString());
+
+			return false;
+		}
+	}
+
 	// Flexible Origin adaptation:
 	if (Origin != Actor->GetActorLocation())
 	{
@@ -2284,6 +4107,53 @@ bool ADonNavigationManager::SchedulePathfindingTask(AActor* Actor, FVector Desti
 			ResultHandlerDelegate, 
 			DynamicCollisionListener
 		);
+
+	// Incremental replanning: (the retained search tree is picked up or started over on the worker thread, see TickNavigationSolver_Incremental)
+	if (QueryParams.bIncrementalReplanning && !bIsUnbound && !voxelCollisionProfile.RelativeVoxelOccupancy.Num())
+	{
+		request.Data.bIncrementalQuery = true;
+		request.Data.IncrementalPlanner = AcquireIncrementalPlanner(Actor);
+	}
+
+	// Sparse voxel octree: pawns occupying a single voxel search octree leaves instead of voxels
+	if (bUseSparseVoxelOctree && !bIsUnbound && !request.Data.bIncrementalQuery && !voxelCollisionProfile.RelativeVoxelOccupancy.Num())
+	{
+		FRWScopeLock lock(SparseVoxelOctreeLock, SLT_ReadOnly);
+
+		auto& data = request.Data;
+		data.OriginNode_Sparse = SparseVoxelOctree.LeafAt(VoxelCoords(originVolume));
+		data.DestinationNode_Sparse = SparseVoxelOctree.LeafAt(VoxelCoords(destinationVolume));
+
+		if (data.OriginNode_Sparse != INDEX_NONE && data.DestinationNode_Sparse != INDEX_NONE)
+		{
+			data.bSparseOctreeQuery = true;
+
+			data.Frontier_Sparse.put(data.OriginNode_Sparse, 0);
+			data.NodeVsCostMap_Sparse.Add(data.OriginNode_Sparse, 0);
+		}
+	}
+
+	// Anytime search: the first pass runs with an inflated heuristic
+	if (QueryParams.bAnytimeSearch && !bIsUnbound && !request.Data.bSparseOctreeQuery && !request.Data.bIncrementalQuery)
+	{
+		request.Data.bAnytimeQuery = true;
+		request.Data.HeuristicWeight_Anytime = FMath::Max(1.f, QueryParams.AnytimeInitialHeuristicWeight);
+	}
+
+	// Hierarchical pathfinding: (the corridor is resolved on the worker thread, see TickNavigationSolver)
+	if (bUseHierarchicalPathfinding && !bIsUnbound && !request.Data.bSparseOctreeQuery && !request.Data.bIncrementalQuery && !voxelCollisionProfile.RelativeVoxelOccupancy.Num() && HierarchicalGraph.IsValid())
+		request.Data.bHierarchicalQuery = true;
+
+	// Unbound worlds search integer voxel coordinates:
+	if (bIsUnbound)
+	{
+		auto& data = request.Data;
+		data.OriginVoxel_Unbound = FDonNavigationVoxelKey(FIntVector(VolumeIdAt(resolvedOriginCenter)));
+		data.DestinationVoxel_Unbound = FDonNavigationVoxelKey(FIntVector(VolumeIdAt(resolvedDestinationCenter)));
+
+		data.Frontier_Unbound.put(data.OriginVoxel_Unbound, 0);
+		data.VolumeVsCostMap_Unbound.Add(data.OriginVoxel_Unbound, 0);
+	}
 	// Schedule this task
 	AddPathfindingTask(request);
 	
@@ -2433,19 +4303,61 @@ void ADonNavigationManager::StopListeningToDynamicCollisionsForPathIndex(FDonNav
 		return;
 	}
 
-	volume->DynamicCollisionNotifyees.RemoveAll([&ListenerToClear](const FDonNavigationDynamicCollisionNotifyee& notifyee) {return notifyee.Listener == ListenerToClear; });
+	FScopeLock lock(&VoxelCollisionNotifyeesLock);
+
+	RemoveCollisionListenerFromVolume(volume, ListenerToClear);
 
 	if (QueryData.QueryParams.bPreciseDynamicCollisionRepathing)
 	{
+		const FIntVector coords = VoxelCoords(volume);
+
 		for (auto offset : QueryData.VoxelCollisionProfile.RelativeVoxelOccupancy)
 		{
-			auto volumeFromProfile = VolumeAtSafe(volume->X + offset.X, volume->Y + offset.Y, volume->Z + offset.Z);
+			auto volumeFromProfile = VolumeAtSafe(coords.X + offset.X, coords.Y + offset.Y, coords.Z + offset.Z);
 			if (volumeFromProfile)
-				volumeFromProfile->DynamicCollisionNotifyees.RemoveAll([&ListenerToClear](const FDonNavigationDynamicCollisionNotifyee& notifyee) {return notifyee.Listener == ListenerToClear; });
+				RemoveCollisionListenerFromVolume(volumeFromProfile, ListenerToClear);
 		}
 	}
 }
 
+void ADonNavigationManager::RemoveCollisionListenerFromVolume(FDonNavigationVoxel* Volume, const FDonNavigationDynamicCollisionDelegate& ListenerToClear)
+{
+	const int32 volumeIndex = VoxelIndex(Volume);
+
+	auto notifyees = VoxelCollisionNotifyees.Find(volumeIndex);
+	if (!notifyees)
+		return;
+
+	notifyees->RemoveAll([&ListenerToClear](const FDonNavigationDynamicCollisionNotifyee& notifyee) {return notifyee.Listener == ListenerToClear; });
+
+	// Keep the side table sparse:
+	if (!notifyees->Num())
+		VoxelCollisionNotifyees.Remove(volumeIndex);
+}
+
+void ADonNavigationManager::BeginVoxelSearch(FDoNNavigationQueryData& Data)
+{
+	Data.SearchState = SearchStatePool.Acquire(NAVVolumeData.NumBricks);
+	Data.SearchState->Visit(VoxelIndex(Data.OriginVolume), 0.f, INDEX_NONE);
+	Data.SearchState->PushOpen(VoxelIndex(Data.OriginVolume), 0.f);
+}
+
+void ADonNavigationManager::EndVoxelSearch(FDoNNavigationQueryData& Data)
+{
+	SearchStatePool.Release(Data.SearchState);
+	Data.SearchState = nullptr;
+
+	// (the search tree itself stays with the manager for the actor's next query)
+	Data.IncrementalPlanner.Reset();
+
+	if (Data.bAnytimeQuery)
+	{
+		FScopeLock lock(&AnytimeBestPathsLock);
+
+		AnytimeBestPaths.Remove(Data.Actor);
+	}
+}
+
 void ADonNavigationManager::AbortPathfindingTaskByIndex(int32 TaskIndex)
 {
 	auto owner = ActiveNavigationTasks[TaskIndex].Data.Actor.Get();
@@ -2453,6 +4365,8 @@ void ADonNavigationManager::AbortPathfindingTaskByIndex(int32 TaskIndex)
 	auto collisionListener = ActiveNavigationTasks[TaskIndex].DynamicCollisionListener;
 
 	StopListeningToDynamicCollisionsForPath(collisionListener, ActiveNavigationTasks[TaskIndex].Data);
+
+	EndVoxelSearch(ActiveNavigationTasks[TaskIndex].Data);
 		
 	ActiveNavigationTasks.RemoveAtSwap(TaskIndex);
 
@@ -2466,13 +4380,45 @@ void ADonNavigationManager::TickNavigationSolver(FDonNavigationQueryTask& task)
 {	
 	auto& data = task.Data;
 
+	if (data.bSparseOctreeQuery)
+	{
+		TickNavigationSolver_SparseOctree(task);
+		return;
+	}
+
+	if (data.bIncrementalQuery)
+	{
+		TickNavigationSolver_Incremental(task);
+		return;
+	}
+
 	data.SolverIterationCount++;
 
-	if (!data.Frontier.empty())
+	// Search the cluster graph before anything else:
+	if (data.bHierarchicalQuery && !data.bCorridorResolved_Hierarchical)
+		ResolveHierarchicalCorridor(data);
+
+	if (!data.SearchState)
+		BeginVoxelSearch(data);
+
+	// The corridor only approximates connectivity between clusters. Ran out of voxels inside it? Drop it and search the whole grid from scratch:
+	if (data.bHierarchicalQuery && data.SearchState->IsOpenListEmpty() && !data.PathSolution_Anytime.Num())
+	{
+		data.bHierarchicalQuery = false;
+		data.Corridor_Hierarchical.Empty();
+
+		data.ClosestVolume_Partial = nullptr;
+		data.ClosestDistance_Partial = MAX_flt;
+
+		SearchStatePool.Release(data.SearchState);
+		BeginVoxelSearch(data);
+	}
+
+	if (!data.SearchState->IsOpenListEmpty())
 	{
 		// Move towards goal by fetching the "best neighbor" of the previous volume from the Frontier priority queue
 		// The best neighbor is defined as the node most likely to lead us towards the goal
-		auto currentVolume = data.Frontier.get(); 
+		auto currentVolume = VolumeAtIndex(data.SearchState->PopOpen()); 
 
 		// Hang & Lowell : 0 - A Star, 1 - Theta Star, 2 - Lazy Theta Star
 		switch (data.QueryParams.AlgorithmType)
@@ -2491,13 +4437,34 @@ void ADonNavigationManager::TickNavigationSolver(FDonNavigationQueryTask& task)
 			return;
 		}
 		
-		if (data.DebugParams.DrawDebugClosedListVolumes && !data.VolumeClosedList.Contains(currentVolume))
+		const int32 currentIndex = VoxelIndex(currentVolume);
+
+		if (data.DebugParams.DrawDebugClosedListVolumes && !data.SearchState->IsClosed(currentIndex))
 		{
 			// Hang & Lowell : draw closed list
-			DrawDebugPoint_Safe(GetWorld(), currentVolume->Location, 6.f, FColor::Green, true, -1.f);
+			DrawDebugPoint_Safe(GetWorld(), VoxelLocation(currentVolume), 6.f, FColor::Green, true, -1.f);
 		}
 		// Add to closed list
-		data.VolumeClosedList.Add(currentVolume);
+		data.SearchState->Close(currentIndex);
+
+		// Keep track of how close we got, in case we run out of time:
+		if (data.QueryParams.bAllowPartialPath)
+		{
+			const float distance = FVector::Dist(VoxelLocation(currentVolume), data.Destination);
+
+			if (distance < data.ClosestDistance_Partial)
+			{
+				data.ClosestDistance_Partial = distance;
+				data.ClosestVolume_Partial = currentVolume;
+			}
+		}
+
+		// Jump Point Search discovers its own successors:
+		if (data.QueryParams.AlgorithmType == 3)
+		{
+			ExpandJumpPointSuccessors(task, currentVolume);
+			return;
+		}
 
 		// Discover all neighbors for current volume:
 		const auto& neighbors = FindOrSetupNeighborsForVolume(currentVolume);
@@ -2509,6 +4476,92 @@ void ADonNavigationManager::TickNavigationSolver(FDonNavigationQueryTask& task)
 	}
 }
 
+void ADonNavigationManager::TickNavigationSolver_SparseOctree(FDonNavigationQueryTask& task)
+{
+	auto& data = task.Data;
+
+	data.SolverIterationCount++;
+
+	if (data.Frontier_Sparse.empty())
+		return;
+
+	const int32 currentNode = data.Frontier_Sparse.get();
+
+	// The frontier has no decrease-key, so nodes may be queued several times. Only the cheapest entry is expanded:
+	if (data.NodeClosedList_Sparse.Contains(currentNode))
+		return;
+
+	FRWScopeLock lock(SparseVoxelOctreeLock, SLT_ReadOnly);
+
+	const auto& nodes = SparseVoxelOctree.Nodes;
+
+	// Dynamic obstacles may have split this leaf after it was queued. Requeue the new leaves that still border our parent, the remaining ones are discovered as their siblings expand.
+	if (!nodes[currentNode].IsLeaf())
+	{
+		const int32* parentNode = data.NodeVsGoalTrajectoryMap_Sparse.Find(currentNode);
+		const auto cost = data.NodeVsCostMap_Sparse.FindRef(currentNode);
+
+		TArray<int32> leaves;
+		SparseVoxelOctree.GetLeavesInNode(currentNode, leaves);
+
+		for (int32 leaf : leaves)
+		{
+			const bool bIsEntryLeaf = parentNode ? FDonSparseVoxelOctree::AreFaceAdjacent(nodes[*parentNode], nodes[leaf]) : leaf == SparseVoxelOctree.LeafAt(VoxelCoords(data.OriginVolume));
+
+			if (!bIsEntryLeaf || !IsSparseNodeNavigable(leaf))
+				continue;
+
+			if (parentNode)
+				data.NodeVsGoalTrajectoryMap_Sparse.Add(leaf, *parentNode);
+			else
+				data.OriginNode_Sparse = leaf;
+
+			data.NodeVsCostMap_Sparse.Add(leaf, cost);
+			data.Frontier_Sparse.put(leaf, cost + FVector::Dist(SparseNodeLocation(leaf), data.Destination));
+		}
+
+		return;
+	}
+
+	// Have we reached the goal? (checked by voxel since the destination leaf itself may have been split along the way)
+	if (currentNode == SparseVoxelOctree.LeafAt(VoxelCoords(data.DestinationVolume)))
+	{
+		data.DestinationNode_Sparse = currentNode;
+		data.bGoalFound = true;
+		return;
+	}
+
+	if (data.DebugParams.DrawDebugClosedListVolumes)
+		DrawDebugPoint_Safe(GetWorld(), SparseNodeLocation(currentNode), 6.f, FColor::Green, true, -1.f);
+
+	data.NodeClosedList_Sparse.Add(currentNode);
+
+	const auto currentCost = data.NodeVsCostMap_Sparse.FindRef(currentNode);
+	const FVector currentLocation = currentNode == data.OriginNode_Sparse ? data.Origin : SparseNodeLocation(currentNode);
+
+	TArray<int32> neighbors;
+	SparseVoxelOctree.GetFaceNeighbors(currentNode, neighbors);
+
+	for (int32 neighbor : neighbors)
+	{
+		if (data.NodeClosedList_Sparse.Contains(neighbor) || !IsSparseNodeNavigable(neighbor))
+			continue;
+
+		// Travel between leaves always passes through the center of their shared face:
+		const FVector portal = SparsePortalLocation(currentNode, neighbor);
+		const FVector neighborLocation = SparseNodeLocation(neighbor);
+		const auto newCost = currentCost + FVector::Dist(currentLocation, portal) + FVector::Dist(portal, neighborLocation);
+		const auto existingCost = data.NodeVsCostMap_Sparse.Find(neighbor);
+
+		if (existingCost && newCost >= *existingCost)
+			continue;
+
+		data.NodeVsCostMap_Sparse.Add(neighbor, newCost);
+		data.NodeVsGoalTrajectoryMap_Sparse.Add(neighbor, currentNode);
+		data.Frontier_Sparse.put(neighbor, newCost + FVector::Dist(neighborLocation, data.Destination));
+	}
+}
+
 void ADonNavigationManager::PackageRawSolution(FDonNavigationQueryTask& task)
 {
 	task.Data.PathSolutionOptimized = task.Data.PathSolutionRaw;
@@ -2553,23 +4606,19 @@ FDonNavigationVoxel* ADonNavigationManager::ThetaStarReparentByLineOfSight(FDonN
 	// Theta* algorithm 
 	auto current = Current;
 	// Get parent of Current
-	auto value = Task.Data.VolumeVsGoalTrajectoryMap.Find(Current);
-	if (value)
-	{
-		auto parentCurrent = *value;
-		if (parentCurrent)
-		{
-			// Do we have direct access from parent of current to neighbour?
-			FHitResult hitResult;
-			const bool bFindInitialOverlaps = true;
-			auto CollisionComponent = Task.Data.CollisionComponent.Get();
-			const auto& Origin = parentCurrent->Location;
-			const auto& Destination = Neighbor->Location;
-			if (IsDirectPathLineSweep(CollisionComponent, Origin, Destination, hitResult, bFindInitialOverlaps))
-			{
-				// Replace Current with parent of Current by the line of sight test 
-				current = parentCurrent;
-			}
+	auto parentCurrent = VolumeAtIndex(Task.Data.SearchState->GetParent(VoxelIndex(Current)));
+	if (parentCurrent)
+	{
+		// Do we have direct access from parent of current to neighbour?
+		FHitResult hitResult;
+		const bool bFindInitialOverlaps = true;
+		auto CollisionComponent = Task.Data.CollisionComponent.Get();
+		const FVector Origin = VoxelLocation(parentCurrent);
+		const FVector Destination = VoxelLocation(Neighbor);
+		if (IsDirectPathLineSweep(CollisionComponent, Origin, Destination, hitResult, bFindInitialOverlaps))
+		{
+			// Replace Current with parent of Current by the line of sight test 
+			current = parentCurrent;
 		}
 	}
 	return current;
@@ -2580,14 +4629,10 @@ FDonNavigationVoxel* ADonNavigationManager::LazyThetaStarReparentByLineOfSight(F
 	// Lazy Theta* algorithm
 	auto current = Current;
 	// Get parent of Current
-	auto value = Task.Data.VolumeVsGoalTrajectoryMap.Find(Current);
-	if (value)
+	auto parentCurrent = VolumeAtIndex(Task.Data.SearchState->GetParent(VoxelIndex(Current)));
+	if (parentCurrent)
 	{
-		auto parentCurrent = *value;
-		if (parentCurrent)
-		{
-			current = parentCurrent;
-		}
+		current = parentCurrent;
 	}
 	return current;
 }
@@ -2598,55 +4643,51 @@ void ADonNavigationManager::LazyThetaStarRegressByLineOfSight(FDonNavigationQuer
 	auto currentVolume = Current;
 	// Get parent of currentVolume
 	auto& data = Task.Data;
-	auto value = data.VolumeVsGoalTrajectoryMap.Find(currentVolume);
-	if (value)
-	{
-		auto parentCurrent = *value;
-		if (parentCurrent)
-		{
-			// Do we have direct access from parent of current to neighbour?
-			FHitResult hitResult;
-			const bool bFindInitialOverlaps = true;
-			auto CollisionComponent = data.CollisionComponent.Get();
-			const auto& Origin = parentCurrent->Location;
-			const auto& Destination = currentVolume->Location;
-			if (!IsDirectPathLineSweep(CollisionComponent, Origin, Destination, hitResult, bFindInitialOverlaps))
+	auto& search = *data.SearchState;
+	auto parentCurrent = VolumeAtIndex(search.GetParent(VoxelIndex(currentVolume)));
+	if (parentCurrent)
+	{
+		// Do we have direct access from parent of current to neighbour?
+		FHitResult hitResult;
+		const bool bFindInitialOverlaps = true;
+		auto CollisionComponent = data.CollisionComponent.Get();
+		const FVector Origin = VoxelLocation(parentCurrent);
+		const FVector Destination = VoxelLocation(currentVolume);
+		if (!IsDirectPathLineSweep(CollisionComponent, Origin, Destination, hitResult, bFindInitialOverlaps))
+		{
+			// Regress to AStar because line of sight assumption is violated
+			auto neighbors = FindOrSetupNeighborsForVolume(currentVolume);
+			// Remove neighbors that are not in the closed list
+			neighbors.RemoveAll([this, &search](const auto& item) { return !search.IsClosed(VoxelIndex(item)); });
+			if (neighbors.Num() > 0)
 			{
-				// Regress to AStar because line of sight assumption is violated
-				auto neighbors = FindOrSetupNeighborsForVolume(currentVolume);
-				// Remove neighbors that are not in the closed list
-				neighbors.RemoveAll([&data](const auto& item) { return !data.VolumeClosedList.Contains(item); });
-				if (neighbors.Num() > 0)
+				std::vector<float> AStarCosts;
+				for (auto& Neighbor : neighbors)
 				{
-					std::vector<float> AStarCosts;
-					for (auto& Neighbor : neighbors)
-					{
 #if OPTIMIZE_SEGMENT
-						auto SegmentDist = VoxelSize;
+					auto SegmentDist = VoxelSize;
 #else
-						auto SegmentDist = VoxelSize * FDonNavigationVoxel::DistanceL2(*currentVolume, *Neighbor);
+					auto SegmentDist = VoxelSize * VoxelDistanceL2(VoxelCoords(currentVolume), VoxelCoords(Neighbor));
 #endif
-						auto newCost = *data.VolumeVsCostMap.Find(Neighbor) + SegmentDist;
-						AStarCosts.push_back(newCost);
-					}
-					auto minArg = std::min_element(AStarCosts.begin(), AStarCosts.end());
-					parentCurrent = neighbors[std::distance(AStarCosts.begin(), minArg)];
-
-					// Update parent and cost with values that would come from plain AStar
-					data.VolumeVsGoalTrajectoryMap.Add(currentVolume, parentCurrent);
-					data.VolumeVsCostMap.Add(currentVolume, *minArg);
-					//UE_LOG(DoNNavigationLog, Display, TEXT("%s"), *FString::Printf(TEXT("Regress to Astar!")));
-				}
-				else
-				{
-					UE_LOG(DoNNavigationLog, Error, TEXT("%s"), *FString::Printf(TEXT("Regress to Astar Failed!")));
+					auto newCost = search.GetCost(VoxelIndex(Neighbor)) + SegmentDist;
+					AStarCosts.push_back(newCost);
 				}
+				auto minArg = std::min_element(AStarCosts.begin(), AStarCosts.end());
+				parentCurrent = neighbors[std::distance(AStarCosts.begin(), minArg)];
+
+				// Update parent and cost with values that would come from plain AStar
+				search.Visit(VoxelIndex(currentVolume), *minArg, VoxelIndex(parentCurrent));
+				//UE_LOG(DoNNavigationLog, Display, TEXT("%s"), *FString::Printf(TEXT("Regress to Astar!")));
 			}
 			else
 			{
-				//UE_LOG(DoNNavigationLog, Display, TEXT("%s"), *FString::Printf(TEXT("Keep Theta Star!")));
+				UE_LOG(DoNNavigationLog, Error, TEXT("%s"), *FString::Printf(TEXT("Regress to Astar Failed!")));
 			}
 		}
+		else
+		{
+			//UE_LOG(DoNNavigationLog, Display, TEXT("%s"), *FString::Printf(TEXT("Keep Theta Star!")));
+		}
 	}
 }
 
@@ -2658,6 +4699,10 @@ void ADonNavigationManager::TickScheduledPathfindingTasks(float DeltaSeconds, in
 	if (!numTasks)
 		return;
 
+	// Whatever dynamic obstacles changed since the last tick, all at once and on the solver's own thread:
+	if (HierarchicalGraph.IsValid())
+		FlushHierarchicalGraphUpdates();
+
 	if (numTasks <= MaxIterationsPerTick)
 	{
 		maxTasksThisIteration = numTasks;
@@ -2676,6 +4721,11 @@ void ADonNavigationManager::TickScheduledPathfindingTasks(float DeltaSeconds, in
 		auto& task = ActiveNavigationTasks[i];
 		auto& data = task.Data;
 
+		// Anytime search out of time while refining? Settle for the best path found so far:
+		if (data.bAnytimeQuery && !data.bGoalFound && data.PathSolution_Anytime.Num()
+		 && (data.GetRefinementTime_Anytime() >= data.QueryParams.AnytimeTimeBudget || data.SolverTimeTaken >= data.QueryParams.QueryTimeout))
+			SettleAnytimeSearch(data);
+
 		// Query timeout?
 		if (data.SolverTimeTaken >= data.QueryParams.QueryTimeout)
 		{
@@ -2689,7 +4739,18 @@ void ADonNavigationManager::TickScheduledPathfindingTasks(float DeltaSeconds, in
 				VisualizeSolution(data.Origin, data.Destination, data.PathSolutionRaw, data.PathSolutionOptimized, data.QueryParams, data.DebugParams);
 
 				data.QueryStatus = EDonNavigationQueryStatus::Success;
-			}			
+			}
+			// Otherwise head for the explored voxel closest to the destination, if the caller is happy with that:
+			else if (data.QueryParams.bAllowPartialPath && PreparePartialSolution(task))
+			{
+				UE_LOG(DoNNavigationLog, Warning, TEXT("Query timed out for Actor %s, returning partial solution ending %f units from the destination. Num iterations : %d"), *data.GetActorName(), data.ClosestDistance_Partial, data.SolverIterationCount);
+
+				PackageRawSolution(task);
+
+				VisualizeSolution(data.Origin, data.PathSolutionRaw.Last(), data.PathSolutionRaw, data.PathSolutionOptimized, data.QueryParams, data.DebugParams);
+
+				data.QueryStatus = EDonNavigationQueryStatus::PartialSuccess;
+			}
 			else
 			{
 				UE_LOG(DoNNavigationLog, Error, TEXT("Query timed out for Actor %s. Num iterations : %d"), *data.GetActorName(), data.SolverIterationCount);
@@ -2709,7 +4770,12 @@ void ADonNavigationManager::TickScheduledPathfindingTasks(float DeltaSeconds, in
 			while (!data.bGoalFound && iterationsProcessed <= maxIterationsPerTask)
 			{
 				TickNavigationSolver(task);
-				iterationsProcessed++;
+				iterationsProcessed += 1 + data.SolverIterationsCharged;
+				data.SolverIterationsCharged = 0;
+
+				// Anytime search: keep this pass's path and look for a better one while time allows
+				if (data.bGoalFound && data.bAnytimeQuery && data.HeuristicWeight_Anytime > 1.f && data.GetRefinementTime_Anytime() < data.QueryParams.AnytimeTimeBudget)
+					BeginAnytimeRefinementPass(task);
 			}
 
 			data.SolverTimeTaken += DeltaSeconds;
@@ -2720,7 +4786,7 @@ void ADonNavigationManager::TickScheduledPathfindingTasks(float DeltaSeconds, in
 				TickNavigationOptimizerCycle(task, iterationsProcessed, maxIterationsPerTask);
 			}
 			// Or path has no solution?
-			else if (data.Frontier.empty() && data.Frontier_Unbound.empty())
+			else if (data.IsFrontierEmpty())
 			{
 				UE_LOG(DoNNavigationLog, Error, TEXT("No pathfinding solution exists for query %s, %s"), *data.GetActorName(), *data.Destination.ToString());
 
@@ -2753,6 +4819,8 @@ void ADonNavigationManager::CompleteNavigationTask(int32 TaskIndex)
 		// During synchronous calls the delegate owner is capable of internally launching of a new query that will check for the existing task when we execute the delegate.
 		// Therefore, to ensure deterministic behavior we first remove the task and only _then_ launch the delegte on a safe copy:
 
+		EndVoxelSearch(ActiveNavigationTasks[TaskIndex].Data);
+
 		auto task_safecopy = ActiveNavigationTasks[TaskIndex];
 
 		// Remove this task
@@ -2767,6 +4835,8 @@ void ADonNavigationManager::CompleteNavigationTask(int32 TaskIndex)
 	{
 		auto owner = ActiveNavigationTasks[TaskIndex].Data.Actor.Get();
 
+		EndVoxelSearch(ActiveNavigationTasks[TaskIndex].Data);
+
 		CompletedNavigationTasks.Enqueue(ActiveNavigationTasks[TaskIndex]);
 		ActiveNavigationTasks.RemoveAtSwap(TaskIndex);
 
@@ -2781,11 +4851,144 @@ bool ADonNavigationManager::PrepareSolution(FDonNavigationQueryTask& Task)
 {
 	auto& data = Task.Data;
 
-	bool bGoalFound = PathSolutionFromVolumeTrajectoryMap(data.OriginVolume, data.DestinationVolume, data.VolumeVsGoalTrajectoryMap, data.VolumeSolution, data.PathSolutionRaw, data.Origin, data.Destination, data.DebugParams);
+	if (data.bSparseOctreeQuery)
+		return PrepareSolution_SparseOctree(Task);
+
+	if (data.bIncrementalQuery)
+		return PrepareSolution_Incremental(Task);
+
+	// (already in place, see SettleAnytimeSearch)
+	if (data.bSolutionSettled_Anytime)
+		return true;
+
+	bool bGoalFound = PathSolutionFromVolumeTrajectoryMap(data.OriginVolume, data.DestinationVolume, *data.SearchState, data.VolumeSolution, data.PathSolutionRaw, data.Origin, data.Destination, data.DebugParams);
 
 	return bGoalFound;
 }
 
+bool ADonNavigationManager::PrepareSolution_SparseOctree(FDonNavigationQueryTask& Task)
+{
+	auto& data = Task.Data;
+
+	// The trajectory map operates in reverse, so work our way back from the destination leaf:
+	TArray<int32> nodeSolution;
+	nodeSolution.Add(data.DestinationNode_Sparse);
+
+	while (nodeSolution[0] != data.OriginNode_Sparse)
+	{
+		auto nextNode = data.NodeVsGoalTrajectoryMap_Sparse.Find(nodeSolution[0]);
+		if (!nextNode || nodeSolution.Contains(*nextNode))
+			return false;
+
+		nodeSolution.Insert(*nextNode, 0);
+	}
+
+	FRWScopeLock lock(SparseVoxelOctreeLock, SLT_ReadOnly);
+
+	// Origin -> portal -> leaf center -> portal -> ... -> portal -> Destination. Every segment lies within a single leaf, so the raw path never crosses an obstacle.
+	data.PathSolutionRaw.Add(data.Origin);
+
+	for (int32 i = 1; i < nodeSolution.Num(); i++)
+	{
+		data.PathSolutionRaw.Add(SparsePortalLocation(nodeSolution[i - 1], nodeSolution[i]));
+
+		if (i < nodeSolution.Num() - 1)
+			data.PathSolutionRaw.Add(SparseNodeLocation(nodeSolution[i]));
+	}
+
+	data.PathSolutionRaw.Add(data.Destination);
+
+	for (const auto& point : data.PathSolutionRaw)
+	{
+		if (auto volume = VolumeAt(point))
+			data.VolumeSolution.Add(volume);
+	}
+
+	return true;
+}
+
+void ADonNavigationManager::TickNavigationSolver_Incremental(FDonNavigationQueryTask& task)
+{
+	auto& data = task.Data;
+	auto& planner = *data.IncrementalPlanner;
+
+	data.SolverIterationCount++;
+
+	auto isNavigable = [this](const FIntVector& Voxel) { auto volume = VolumeAtSafe(Voxel.X, Voxel.Y, Voxel.Z); return volume && CanNavigate(volume); };
+
+	// Pick up this actor's previous search tree if it was headed to the same goal:
+	if (data.SolverIterationCount == 1)
+	{
+		const FIntVector start = VoxelCoords(data.OriginVolume);
+		const FIntVector goal = VoxelCoords(data.DestinationVolume);
+
+		if (planner.IsValid() && planner.GetGoal() == goal)
+			planner.MoveStart(start);
+		else
+			planner.Reset(start, goal);
+	}
+
+	const bool bSearchComplete = planner.Step(isNavigable);
+
+	// Each expansion re-evaluates the edges of all 18 neighbors, charge it by the voxels probed (a regular expansion probes about as many as it has neighbors):
+	data.SolverIterationsCharged += planner.TakeNumProbes() / 18;
+
+	if (bSearchComplete && planner.HasPath())
+	{
+		data.bGoalFound = true;
+		return;
+	}
+
+	const bool bTooLarge = MaxIncrementalPlannerStates > 0 && planner.NumStates() > MaxIncrementalPlannerStates;
+	if (!bSearchComplete && !bTooLarge)
+		return;
+
+	if (bTooLarge)
+		UE_LOG(DoNNavigationLog, Verbose, TEXT("Incremental search tree for %s exceeded %d voxels and was discarded"), *data.GetActorName(), MaxIncrementalPlannerStates);
+
+	// The planner never squeezes past outer corners (USE_26_DOFs), so let the regular solver have the final word.
+	// A tree that can't reach the goal (or has grown too large) isn't worth keeping around either:
+	planner.Discard();
+	data.bIncrementalQuery = false;
+}
+
+bool ADonNavigationManager::PrepareSolution_Incremental(FDonNavigationQueryTask& Task)
+{
+	auto& data = Task.Data;
+
+	auto isNavigable = [this](const FIntVector& Voxel) { auto volume = VolumeAtSafe(Voxel.X, Voxel.Y, Voxel.Z); return volume && CanNavigate(volume); };
+
+	TArray<FIntVector> voxelSolution;
+	if (!data.IncrementalPlanner->ExtractPath(isNavigable, voxelSolution))
+		return false;
+
+	// Same layout as PathSolutionFromVolumeTrajectoryMap: voxel centers from the origin voxel onwards, ending at the exact destination
+	if (voxelSolution.Num() == 1)
+	{
+		auto volume = &VolumeAtUnsafe(voxelSolution[0].X, voxelSolution[0].Y, voxelSolution[0].Z);
+
+		data.VolumeSolution.Add(volume);
+		data.VolumeSolution.Add(volume);
+
+		data.PathSolutionRaw.Add(data.Origin);
+		data.PathSolutionRaw.Add(data.Destination);
+
+		return true;
+	}
+
+	for (const FIntVector& voxel : voxelSolution)
+	{
+		auto volume = &VolumeAtUnsafe(voxel.X, voxel.Y, voxel.Z);
+
+		data.VolumeSolution.Add(volume);
+		data.PathSolutionRaw.Add(VoxelLocation(volume));
+	}
+
+	data.PathSolutionRaw.Last() = data.Destination;
+
+	return true;
+}
+
 void ADonNavigationManager::TickNavigationOptimizerCycle(FDonNavigationQueryTask& task, int32& IterationsProcessed, const int32 MaxIterationsPerTask)
 {
 	auto& data = task.Data;
@@ -2798,7 +5001,7 @@ void ADonNavigationManager::TickNavigationOptimizerCycle(FDonNavigationQueryTask
 
 		if(!data.bGoalFound)
 		{
-			UE_LOG(DoNNavigationLog, Error, TEXT("%s"), *FString::Printf(TEXT("Query complete, but goal not found in %d trajectory nodes. Unable to proceed"), data.VolumeVsGoalTrajectoryMap.Num()));
+			UE_LOG(DoNNavigationLog, Error, TEXT("%s"), *FString::Printf(TEXT("Query complete, but goal not found in %d trajectory nodes. Unable to proceed"), data.SearchState ? data.SearchState->NumVisited() : data.VolumeVsGoalTrajectoryMap_Unbound.Num()));
 
 			data.QueryStatus = EDonNavigationQueryStatus::Failure;
 
@@ -2939,14 +5142,33 @@ void ADonNavigationManager::AddCollisionListenerToVolumeFromTask(FDonNavigationV
 	if (!Volume || !task.DynamicCollisionListener.IsBound())
 		return;
 
+	const FIntVector coords = VoxelCoords(Volume);
+
 	auto listener = task.DynamicCollisionListener;
-	auto payload = FDonNavigationDynamicCollisionPayload(task.Data.QueryParams.CustomDelegatePayload, *Volume);
+	auto payload = FDonNavigationDynamicCollisionPayload(task.Data.QueryParams.CustomDelegatePayload, coords, VoxelLocation(Volume));
 	auto notifyee = FDonNavigationDynamicCollisionNotifyee(listener, payload);
 
+	FScopeLock lock(&VoxelCollisionNotifyeesLock);
+
+	notifyee.RegisteredAt = ++CollisionListenerSerial;
+
+	// Listeners registered again are stamped again, obstacles already sitting on their voxels need to tell them as well:
+	auto addNotifyee = [&notifyee](TArray<FDonNavigationDynamicCollisionNotifyee>& Notifyees)
+	{
+		const int32 existing = Notifyees.Find(notifyee);
+
+		if (existing == INDEX_NONE)
+			Notifyees.Add(notifyee);
+		else
+			Notifyees[existing].RegisteredAt = notifyee.RegisteredAt;
+	};
+
+	auto& notifyees = VoxelCollisionNotifyees.FindOrAdd(VoxelIndex(Volume));
+
 #if WITH_EDITOR	
-	if (bRunDebugValidationsForDynamicCollisions && Volume->DynamicCollisionNotifyees.Contains(notifyee))
+	if (bRunDebugValidationsForDynamicCollisions && notifyees.Contains(notifyee))
 	{
-		FString errorMessage = FString::Printf(TEXT("ALERT: Navigator %s is attempting to add a duplicate collision listener to volume %d %d %d \n"), *task.Data.GetActorName(), Volume->X, Volume->Y, Volume->Z);
+		FString errorMessage = FString::Printf(TEXT("ALERT: Navigator %s is attempting to add a duplicate collision listener to volume %d %d %d \n"), *task.Data.GetActorName(), coords.X, coords.Y, coords.Z);
 		errorMessage += FString("This is usually a sign that you're not deregistering collision listeners after you're done using a navigation query.\n");
 		errorMessage += FString("Please ensure that _any_ code scheduling a navigation task even once _must_ clear all the collision listeners it acquires \n");
 		errorMessage += FString("after it is no longer interested in listening to dynamic collision along the requested path. This is also vital to maintain optimal performance.\n");
@@ -2956,16 +5178,16 @@ void ADonNavigationManager::AddCollisionListenerToVolumeFromTask(FDonNavigationV
 	
 	
 	// Add dynamic listeners:
-	Volume->DynamicCollisionNotifyees.AddUnique(notifyee);	
+	addNotifyee(notifyees);
 
 	if (task.Data.QueryParams.bPreciseDynamicCollisionRepathing)
 	{
 		for (auto offset : task.Data.VoxelCollisionProfile.RelativeVoxelOccupancy)
 		{
-			auto volumeFromProfile = VolumeAtSafe(Volume->X + offset.X, Volume->Y + offset.Y, Volume->Z + offset.Z);
+			auto volumeFromProfile = VolumeAtSafe(coords.X + offset.X, coords.Y + offset.Y, coords.Z + offset.Z);
 			if (volumeFromProfile)
 			{
-				volumeFromProfile->DynamicCollisionNotifyees.AddUnique(notifyee);				
+				addNotifyee(VoxelCollisionNotifyees.FindOrAdd(VoxelIndex(volumeFromProfile)));
 			}
 		}
 	}
@@ -3064,7 +5286,7 @@ FVector ADonNavigationManager::FindRandomPointAroundOriginInNavWorld(AActor* Nav
 			{
 				bFoundValidResult = true;
 
-				return destinationVolume->Location;
+				return VoxelLocation(destinationVolume);
 			}
 		}
 	}
@@ -3090,16 +5312,19 @@ bool ADonNavigationManager::IsLocationBeneathLandscape(FVector Location, float L
 
 void ADonNavigationManager::VisualizeDynamicCollisionListeners(FDonNavigationDynamicCollisionDelegate Listener, UPARAM(ref) const FDoNNavigationQueryData& QueryData)
 {
+	FScopeLock lock(&VoxelCollisionNotifyeesLock);
+
 	for (auto volume : QueryData.VolumeSolutionOptimized)
 	{	
-		bool bContainsListener = volume->DynamicCollisionNotifyees.ContainsByPredicate([&Listener](const FDonNavigationDynamicCollisionNotifyee& notifyee) {return notifyee.Listener == Listener; });
+		auto notifyees = VoxelCollisionNotifyees.Find(VoxelIndex(volume));
+		bool bContainsListener = notifyees && notifyees->ContainsByPredicate([&Listener](const FDonNavigationDynamicCollisionNotifyee& notifyee) {return notifyee.Listener == Listener; });
 		if (bContainsListener)
 		{	
-			DrawDebugVoxel_Safe(GetWorld(), volume->Location, NavVolumeExtent(), FColor::Yellow, true, -1.f, 0, DebugVoxelsLineThickness);
+			DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(volume), NavVolumeExtent(), FColor::Yellow, true, -1.f, 0, DebugVoxelsLineThickness);
 		}
 		else
 		{	
-			DrawDebugVoxel_Safe(GetWorld(), volume->Location, NavVolumeExtent(), FColor::Red, true, -1.f, 0, DebugVoxelsLineThickness);
+			DrawDebugVoxel_Safe(GetWorld(), VoxelLocation(volume), NavVolumeExtent(), FColor::Red, true, -1.f, 0, DebugVoxelsLineThickness);
 		}
 	}
 }
@@ -3151,6 +5376,10 @@ void ADonNavigationManager::VisualizeSolution(FVector source, FVector destinatio
 			c = FColor::Orange;
 			sDist = FString::Printf(TEXT("Total distance Lazy Theta* raw: %.4f cm"), total_distance);
 			break;
+		case 3:
+			c = FColor::Cyan;
+			sDist = FString::Printf(TEXT("Total distance JPS raw: %.4f cm"), total_distance);
+			break;
 		default:
 			break;
 		}	
@@ -3191,6 +5420,10 @@ void ADonNavigationManager::VisualizeSolution(FVector source, FVector destinatio
 			c = FColor::Orange;
 			sDist = FString::Printf(TEXT("Total distance Lazy Theta* optimized: %.4f cm"), total_distance);
 			break;
+		case 3:
+			c = FColor::Cyan;
+			sDist = FString::Printf(TEXT("Total distance JPS optimized: %.4f cm"), total_distance);
+			break;
 		default:
 			break;
 		}
@@ -0,0 +1,114 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "DonNavigationManagerSlidingWindow.h"
+#include "DonAINavigationPrivatePCH.h"
+
+ADonNavigationManagerSlidingWindow::ADonNavigationManagerSlidingWindow(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	// The manager's location is the window's origin
+	SceneComponent->Mobility = EComponentMobility::Movable;
+}
+
+void ADonNavigationManagerSlidingWindow::BeginPlay()
+{
+	if (bUseBakedNavigationGrid || bUseSparseVoxelOctree || bUseHierarchicalPathfinding || bRejectUnreachableQueries)
+	{
+		UE_LOG(DoNNavigationLog, Log, TEXT("%s: baked navigation grids, the sparse voxel octree, hierarchical pathfinding and connectivity labels are not supported by sliding windows and will be ignored"), *GetName());
+
+		bUseBakedNavigationGrid = false;
+		bUseSparseVoxelOctree = false;
+		bUseHierarchicalPathfinding = false;
+		bRejectUnreachableQueries = false;
+	}
+
+	TrackedAgents.Remove(nullptr);
+
+	// Start out centered on the agents, before the grid is generated:
+	FVector center;
+	if (GetTrackedAgentsCenter(center))
+		SetActorLocation(GetActorLocation() + VoxelSize * FVector(GetRecenterShift(center)));
+
+	Super::BeginPlay();
+}
+
+void ADonNavigationManagerSlidingWindow::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	FVector center;
+	if (!GetTrackedAgentsCenter(center))
+		return;
+
+	const FIntVector shift = GetRecenterShift(center);
+
+	if (FMath::Max3(FMath::Abs(shift.X), FMath::Abs(shift.Y), FMath::Abs(shift.Z)) < RecenterThreshold)
+	{
+		// The agents came back before a pending scroll could happen, release whatever was held for it
+		if (bVoxelGridScrollPending)
+			ScrollVoxelGrid(FIntVector::ZeroValue);
+
+		return;
+	}
+
+	// If the solver is busy, new work is held back until it drains and we try again next tick
+	ScrollVoxelGrid(shift, bResampleScrolledSlabsImmediately);
+}
+
+void ADonNavigationManagerSlidingWindow::TrackAgent(AActor* Agent)
+{
+	if (Agent)
+		TrackedAgents.AddUnique(Agent);
+}
+
+void ADonNavigationManagerSlidingWindow::UntrackAgent(AActor* Agent)
+{
+	TrackedAgents.Remove(Agent);
+}
+
+bool ADonNavigationManagerSlidingWindow::RecenterWindow()
+{
+	FVector center;
+	if (!GetTrackedAgentsCenter(center))
+		return false;
+
+	return ScrollVoxelGrid(GetRecenterShift(center), bResampleScrolledSlabsImmediately);
+}
+
+bool ADonNavigationManagerSlidingWindow::GetTrackedAgentsCenter(FVector& OutCenter)
+{
+	FBox agentBounds(ForceInit);
+
+	for (AActor* agent : TrackedAgents)
+	{
+		if (agent && !agent->IsPendingKill())
+			agentBounds += agent->GetActorLocation();
+	}
+
+	if (!agentBounds.IsValid)
+		return false;
+
+	OutCenter = agentBounds.GetCenter();
+
+	return true;
+}
+
+FIntVector ADonNavigationManagerSlidingWindow::GetRecenterShift(const FVector& Center)
+{
+	const FVector windowCenter = GetActorLocation() + VoxelSize * FVector(XGridSize, YGridSize, ZGridSize) / 2;
+	const FVector offset = (Center - windowCenter) / VoxelSize;
+
+	// Whole voxels only, so that the window stays on the same lattice (and keeps every voxel that remains in view)
+	return FIntVector(FMath::RoundToInt(offset.X), FMath::RoundToInt(offset.Y), FMath::RoundToInt(offset.Z));
+}
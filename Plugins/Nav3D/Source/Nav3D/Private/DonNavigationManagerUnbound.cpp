@@ -33,7 +33,7 @@ bool ADonNavigationManagerUnbound::PrepareSolution(FDonNavigationQueryTask& Task
 	auto& data = Task.Data;
 
 	// a rare edgecase, but worth handling gracefully in any case
-	if (data.OriginVolumeCenter == data.DestinationVolumeCenter)
+	if (data.OriginVoxel_Unbound == data.DestinationVoxel_Unbound)
 	{
 		data.PathSolutionRaw.Add(data.Origin);
 		data.PathSolutionRaw.Add(data.Destination);
@@ -44,24 +44,23 @@ bool ADonNavigationManagerUnbound::PrepareSolution(FDonNavigationQueryTask& Task
 	// The trajectory map operates in reverse, so start from the destination:
 	data.PathSolutionRaw.Insert(data.Destination, 0);
 
-	// Work our way back from destination to origin while generating a linear path solution list
+	// Work our way back from destination to origin while generating a linear path solution list. Voxels are only converted to world locations here.
 	bool originFound = false;
-	auto nextLocation = data.VolumeVsGoalTrajectoryMap_Unbound.Find(data.DestinationVolumeCenter);
+	auto nextVoxel = data.VolumeVsGoalTrajectoryMap_Unbound.Find(data.DestinationVoxel_Unbound);
 
-	while (nextLocation)
+	// Note:- a chain can't be longer than the map it was built from, this guards against cycles the same way PathSolutionFromVolumeTrajectoryMap does
+	for (int32 remainingSteps = data.VolumeVsGoalTrajectoryMap_Unbound.Num(); nextVoxel && remainingSteps > 0; remainingSteps--)
 	{
-		if (data.PathSolutionRaw.Contains(*nextLocation))
-			break; // Note:- this was introduced alongisde the bugfix to the bound manager to prevent infinte loops in PathSolutionFromVolumeTrajectoryMap
+		const FIntVector coords = nextVoxel->Coords();
+		data.PathSolutionRaw.Insert(LocationAtId(coords.X, coords.Y, coords.Z), 0);
 
-		data.PathSolutionRaw.Insert((*nextLocation), 0);
-
-		if (*nextLocation == data.OriginVolumeCenter)
+		if (*nextVoxel == data.OriginVoxel_Unbound)
 		{
 			originFound = true;
 			break;
 		}
 
-		nextLocation = data.VolumeVsGoalTrajectoryMap_Unbound.Find(*nextLocation);
+		nextVoxel = data.VolumeVsGoalTrajectoryMap_Unbound.Find(*nextVoxel);
 	}
 
 	return originFound;
@@ -85,87 +84,95 @@ void ADonNavigationManagerUnbound::TickNavigationSolver(FDonNavigationQueryTask&
 	{
 		// Move towards goal by fetching the "best neighbor" of the previous volume from the Frontier priority queue
 		// The best neighbor is defined as the node most likely to lead us towards the goal
-		FVector currentVector = data.Frontier_Unbound.get();
+		const FDonNavigationVoxelKey currentVoxel = data.Frontier_Unbound.get();
 
 		// Have we reached the goal?
-		if (currentVector == data.DestinationVolumeCenter)
+		if (currentVoxel == data.DestinationVoxel_Unbound)
 		{
 			data.bGoalFound = true;
 			return;
 		}
 
 		// Discover all neighbors for current volume:
-		const auto& neighbors = NeighborsAsVectors(currentVector);
+		const auto& neighbors = NeighborsAsVoxels(currentVoxel.Coords());
 
 		// Evaluate each neighbor for suitability, assign points, add to Frontier
 		for (auto neighbor : neighbors)
 		{
-			ExpandFrontierTowardsTarget(task, currentVector, neighbor);
+			ExpandFrontierTowardsTarget(task, currentVoxel, neighbor);
 		}
 	}
 }
 
-TArray<FVector> ADonNavigationManagerUnbound::NeighborsAsVectors(FVector Location)
+TArray<FDonNavigationVoxelKey> ADonNavigationManagerUnbound::NeighborsAsVoxels(const FIntVector& Voxel)
 {
-	TArray<FVector> neighbors;
+	TArray<FDonNavigationVoxelKey> neighbors;
 	neighbors.Reserve(Volume6DOF + VolumeImplicitDOF);
 
+	// (the search never leaves the range voxel keys can address, see FDonNavigationVoxelKey::IsInRange)
+	auto addNeighbor = [&neighbors](int32 X, int32 Y, int32 Z)
+	{
+		if (FDonNavigationVoxelKey::IsInRange(X, Y, Z))
+			neighbors.Emplace(X, Y, Z);
+	};
+
 	// 6 DOF neighbors (Direct neighbors)
 	for (int32 i = 0; i < Volume6DOF; i++)
 	{
-		FVector neighbor = Location + VoxelSize * FVector(x6DOFCoords[i], y6DOFCoords[i], z6DOFCoords[i]);
-
-		neighbors.Add(neighbor);
+		addNeighbor(Voxel.X + x6DOFCoords[i], Voxel.Y + y6DOFCoords[i], Voxel.Z + z6DOFCoords[i]);
 	}
 
 	// Implicit:
+	auto canNavigate = [this, &Voxel](int32 X, int32 Y, int32 Z) { return CanNavigateVoxelAt(Voxel + FIntVector(X, Y, Z)); };
 	
 	// X		
 
-	if (CanNavigate(LocationAtId(Location, 1, 0, 0)) && CanNavigate(LocationAtId(Location, 0, 0, 1)))
-		neighbors.Add(LocationAtId(Location, 1, 0, 1));
+	if (canNavigate(1, 0, 0) && canNavigate(0, 0, 1))
+		addNeighbor(Voxel.X + 1, Voxel.Y, Voxel.Z + 1);
 
-	if (CanNavigate(LocationAtId(Location, -1, 0, 0)) && CanNavigate(LocationAtId(Location, 0, 0, 1)))
-		neighbors.Add(LocationAtId(Location, -1, 0, 1));
+	if (canNavigate(-1, 0, 0) && canNavigate(0, 0, 1))
+		addNeighbor(Voxel.X - 1, Voxel.Y, Voxel.Z + 1);
 
-	if (CanNavigate(LocationAtId(Location, 1, 0, 0)) && CanNavigate(LocationAtId(Location, 0, 0, -1)))
-		neighbors.Add(LocationAtId(Location, 1, 0, -1));
+	if (canNavigate(1, 0, 0) && canNavigate(0, 0, -1))
+		addNeighbor(Voxel.X + 1, Voxel.Y, Voxel.Z - 1);
 
-	if (CanNavigate(LocationAtId(Location, -1, 0, 0)) && CanNavigate(LocationAtId(Location, 0, 0, -1)))
-		neighbors.Add(LocationAtId(Location, -1, 0, -1));
+	if (canNavigate(-1, 0, 0) && canNavigate(0, 0, -1))
+		addNeighbor(Voxel.X - 1, Voxel.Y, Voxel.Z - 1);
 
 	//Y
-	if (CanNavigate(LocationAtId(Location, 0, 1, 0)) && CanNavigate(LocationAtId(Location, 0, 0, 1)))
-		neighbors.Add(LocationAtId(Location, 0, 1, 1));
+	if (canNavigate(0, 1, 0) && canNavigate(0, 0, 1))
+		addNeighbor(Voxel.X, Voxel.Y + 1, Voxel.Z + 1);
 
-	if (CanNavigate(LocationAtId(Location, 0, -1, 0)) && CanNavigate(LocationAtId(Location, 0, 0, 1)))
-		neighbors.Add(LocationAtId(Location, 0, -1, 1));
+	if (canNavigate(0, -1, 0) && canNavigate(0, 0, 1))
+		addNeighbor(Voxel.X, Voxel.Y - 1, Voxel.Z + 1);
 
-	if (CanNavigate(LocationAtId(Location, 0, 1, 0)) && CanNavigate(LocationAtId(Location, 0, 0, -1)))
-		neighbors.Add(LocationAtId(Location, 0, 1, -1));
+	if (canNavigate(0, 1, 0) && canNavigate(0, 0, -1))
+		addNeighbor(Voxel.X, Voxel.Y + 1, Voxel.Z - 1);
 
-	if (CanNavigate(LocationAtId(Location, 0, -1, 0)) && CanNavigate(LocationAtId(Location, 0, 0, -1)))
-		neighbors.Add(LocationAtId(Location, 0, -1, -1));
+	if (canNavigate(0, -1, 0) && canNavigate(0, 0, -1))
+		addNeighbor(Voxel.X, Voxel.Y - 1, Voxel.Z - 1);
 
 	//Z
-	if (CanNavigate(LocationAtId(Location, 1, 0, 0)) && CanNavigate(LocationAtId(Location, 0, 1, 0)))
-		neighbors.Add(LocationAtId(Location, 1, 1, 0));
+	if (canNavigate(1, 0, 0) && canNavigate(0, 1, 0))
+		addNeighbor(Voxel.X + 1, Voxel.Y + 1, Voxel.Z);
 
-	if (CanNavigate(LocationAtId(Location, -1, 0, 0)) && CanNavigate(LocationAtId(Location, 0, 1, 0)))
-		neighbors.Add(LocationAtId(Location, -1, 1, 0));
+	if (canNavigate(-1, 0, 0) && canNavigate(0, 1, 0))
+		addNeighbor(Voxel.X - 1, Voxel.Y + 1, Voxel.Z);
 
-	if (CanNavigate(LocationAtId(Location, 1, 0, 0)) && CanNavigate(LocationAtId(Location, 0, -1, 0)))
-		neighbors.Add(LocationAtId(Location, 1, -1, 0));
+	if (canNavigate(1, 0, 0) && canNavigate(0, -1, 0))
+		addNeighbor(Voxel.X + 1, Voxel.Y - 1, Voxel.Z);
 
-	if (CanNavigate(LocationAtId(Location, -1, 0, 0)) && CanNavigate(LocationAtId(Location, 0, -1, 0)))
-		neighbors.Add(LocationAtId(Location, -1, -1, 0));	
+	if (canNavigate(-1, 0, 0) && canNavigate(0, -1, 0))
+		addNeighbor(Voxel.X - 1, Voxel.Y - 1, Voxel.Z);
 
 	return neighbors;
 }
 
-void ADonNavigationManagerUnbound::ExpandFrontierTowardsTarget(FDonNavigationQueryTask& Task, FVector Current, FVector Neighbor)
+void ADonNavigationManagerUnbound::ExpandFrontierTowardsTarget(FDonNavigationQueryTask& Task, FDonNavigationVoxelKey Current, FDonNavigationVoxelKey Neighbor)
 {
-	if (!CanNavigateByCollisionProfile(Neighbor, Task.Data.VoxelCollisionProfile))
+	const FIntVector neighborCoords = Neighbor.Coords();
+
+	if (!CanNavigateByCollisionProfile(neighborCoords, Task.Data.VoxelCollisionProfile))
 		return;
 
 	auto SegmentDist = VoxelSize;
@@ -178,7 +185,7 @@ void ADonNavigationManagerUnbound::ExpandFrontierTowardsTarget(FDonNavigationQue
 		Task.Data.VolumeVsGoalTrajectoryMap_Unbound.Add(Neighbor, Current);
 		Task.Data.VolumeVsCostMap_Unbound.Add(Neighbor, newCost);
 
-		auto heuristic = FVector::Dist(Neighbor, Task.Data.Destination);
+		auto heuristic = VoxelSize * VoxelDistanceL2(neighborCoords, Task.Data.DestinationVoxel_Unbound.Coords());
 		auto priority = newCost + heuristic;
 
 		Task.Data.Frontier_Unbound.put(Neighbor, priority);
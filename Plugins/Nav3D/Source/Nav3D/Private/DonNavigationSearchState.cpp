@@ -0,0 +1,209 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "DonNavigationSearchState.h"
+#include "DonAINavigationPrivatePCH.h"
+
+void FDonNavigationSearchState::NewSearch(int32 NumBricks)
+{
+	NumBlocksInUse = 0;
+	NumVisitedVoxels = 0;
+	OpenList.Reset();
+
+	if (BrickSlots.Num() != NumBricks)
+	{
+		BrickSlots.Reset();
+		BrickSlots.SetNum(NumBricks);
+		Generation = 0;
+	}
+
+	// Every slot stamped with an older generation is stale. Should the stamp ever wrap around, start over with clean slots:
+	if (++Generation == 0)
+	{
+		for (auto& slot : BrickSlots)
+			slot = FBrickSlot();
+
+		Generation = 1;
+	}
+}
+
+void FDonNavigationSearchState::AssignBlock(FBrickSlot& Slot)
+{
+	// Growing past the largest query served so far is the only time a state allocates
+	if ((NumBlocksInUse + 1) * VoxelsPerBlock > Entries.Num())
+		Entries.AddUninitialized(VoxelsPerBlock);
+
+	Slot.Generation = Generation;
+	Slot.Block = NumBlocksInUse++;
+
+	FMemory::Memzero(&Entries[Slot.Block << VoxelsPerBlockShift], VoxelsPerBlock * sizeof(FEntry));
+}
+
+void FDonNavigationSearchState::PushOpen(int32 Index, float Priority)
+{
+	const int32 slot = FindOrAddEntry(Index).OpenSlot;
+
+	if (slot == INDEX_NONE)
+	{
+		OpenList.Add({ Priority, Index });
+		FindOrAddEntry(Index).OpenSlot = OpenList.Num() - 1;
+
+		SiftUp(OpenList.Num() - 1);
+	}
+	else if (Priority < OpenList[slot].Priority)
+	{
+		// Decrease-key:
+		OpenList[slot].Priority = Priority;
+
+		SiftUp(slot);
+	}
+}
+
+int32 FDonNavigationSearchState::PopOpen()
+{
+	const int32 best = OpenList[0].Index;
+	FindOrAddEntry(best).OpenSlot = INDEX_NONE;
+
+	const FOpenNode last = OpenList.Pop(false);
+
+	if (OpenList.Num())
+	{
+		PlaceOpenNode(last, 0);
+		SiftDown(0);
+	}
+
+	return best;
+}
+
+void FDonNavigationSearchState::ReprioritizeOpen(TFunctionRef<float(int32 Index)> PriorityOf)
+{
+	for (auto& node : OpenList)
+		node.Priority = PriorityOf(node.Index);
+
+	if (OpenList.Num() < 2)
+		return;
+
+	// Bottom-up heapify, starting from the last node that has children:
+	for (int32 slot = (OpenList.Num() - 2) / OpenListArity; slot >= 0; slot--)
+		SiftDown(slot);
+}
+
+void FDonNavigationSearchState::ClearClosed()
+{
+	// Every block in use belongs to the current query
+	for (int32 i = 0, numEntries = NumBlocksInUse << VoxelsPerBlockShift; i < numEntries; i++)
+		Entries[i].bClosed = false;
+}
+
+void FDonNavigationSearchState::SiftUp(int32 Slot)
+{
+	const FOpenNode node = OpenList[Slot];
+
+	while (Slot > 0)
+	{
+		const int32 parent = (Slot - 1) / OpenListArity;
+
+		if (OpenList[parent].Priority <= node.Priority)
+			break;
+
+		PlaceOpenNode(OpenList[parent], Slot);
+		Slot = parent;
+	}
+
+	PlaceOpenNode(node, Slot);
+}
+
+void FDonNavigationSearchState::SiftDown(int32 Slot)
+{
+	const FOpenNode node = OpenList[Slot];
+	const int32 numOpen = OpenList.Num();
+
+	for (;;)
+	{
+		const int32 firstChild = Slot * OpenListArity + 1;
+
+		if (firstChild >= numOpen)
+			break;
+
+		// Cheapest of up to 4 children, which share a cache line:
+		int32 bestChild = firstChild;
+		const int32 lastChild = FMath::Min(firstChild + OpenListArity, numOpen);
+
+		for (int32 child = firstChild + 1; child < lastChild; child++)
+		{
+			if (OpenList[child].Priority < OpenList[bestChild].Priority)
+				bestChild = child;
+		}
+
+		if (node.Priority <= OpenList[bestChild].Priority)
+			break;
+
+		PlaceOpenNode(OpenList[bestChild], Slot);
+		Slot = bestChild;
+	}
+
+	PlaceOpenNode(node, Slot);
+}
+
+FDonNavigationSearchState* FDonNavigationSearchStatePool::Acquire(int32 NumBricks)
+{
+	FDonNavigationSearchState* state = nullptr;
+
+	{
+		FScopeLock lock(&Lock);
+
+		if (FreeStates.Num())
+		{
+			state = FreeStates.Pop(false);
+		}
+		else
+		{
+			States.Add(MakeUnique<FDonNavigationSearchState>());
+			state = States.Last().Get();
+		}
+	}
+
+	state->NewSearch(NumBricks);
+
+	return state;
+}
+
+void FDonNavigationSearchStatePool::Release(FDonNavigationSearchState* State)
+{
+	if (!State)
+		return;
+
+	FScopeLock lock(&Lock);
+
+	if (FreeStates.Num() < MaxPooledStates)
+	{
+		FreeStates.Add(State);
+		return;
+	}
+
+	States.RemoveAllSwap([State](const TUniquePtr<FDonNavigationSearchState>& Item) { return Item.Get() == State; });
+}
+
+void FDonNavigationSearchStatePool::SetMaxPooledStates(int32 MaxPooledStatesIn)
+{
+	FScopeLock lock(&Lock);
+
+	MaxPooledStates = FMath::Max(MaxPooledStatesIn, 0);
+
+	while (FreeStates.Num() > MaxPooledStates)
+	{
+		FDonNavigationSearchState* state = FreeStates.Pop(false);
+		States.RemoveAllSwap([state](const TUniquePtr<FDonNavigationSearchState>& Item) { return Item.Get() == state; });
+	}
+}
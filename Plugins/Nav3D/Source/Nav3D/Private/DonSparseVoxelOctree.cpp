@@ -0,0 +1,237 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "DonSparseVoxelOctree.h"
+#include "DonAINavigationPrivatePCH.h"
+
+void FDonSparseVoxelOctree::Reset()
+{
+	Nodes.Empty();
+	GridSize = FIntVector::ZeroValue;
+}
+
+void FDonSparseVoxelOctree::Build(const FIntVector& GridSizeIn, TFunctionRef<bool(const FIntVector& Min, int32 Size)> IsRegionFree)
+{
+	Reset();
+
+	GridSize = GridSizeIn;
+
+	const int32 largestDimension = FMath::Max3(GridSize.X, GridSize.Y, GridSize.Z);
+	if (largestDimension <= 0)
+		return;
+
+	const int32 rootSize = FMath::RoundUpToPowerOfTwo(largestDimension);
+
+	Nodes.Emplace(FIntVector::ZeroValue, rootSize);
+	BuildNode(0, IsRegionFree);
+
+	Nodes.Shrink();
+}
+
+void FDonSparseVoxelOctree::BuildNode(int32 NodeIndex, TFunctionRef<bool(const FIntVector& Min, int32 Size)> IsRegionFree)
+{
+	// Note:- Nodes may reallocate as we subdivide, so never hold references across calls to Subdivide
+	const FIntVector min = Nodes[NodeIndex].Min;
+	const int32 size = Nodes[NodeIndex].Size;
+
+	if (IsOutsideWorld(min, size))
+	{
+		Nodes[NodeIndex].bOutsideWorld = true;
+		return;
+	}
+
+	// Single voxels are always leaves, their navigability is owned by the voxel grid:
+	if (size == 1)
+		return;
+
+	// Large open region?
+	if (IsInsideWorld(min, size) && IsRegionFree(min, size))
+		return;
+
+	Subdivide(NodeIndex);
+
+	const int32 firstChild = Nodes[NodeIndex].FirstChild;
+	for (int32 i = 0; i < 8; i++)
+		BuildNode(firstChild + i, IsRegionFree);
+}
+
+void FDonSparseVoxelOctree::Subdivide(int32 NodeIndex)
+{
+	const FIntVector min = Nodes[NodeIndex].Min;
+	const int32 half = Nodes[NodeIndex].Size / 2;
+	const int32 firstChild = Nodes.Num();
+
+	for (int32 i = 0; i < 8; i++)
+	{
+		const FIntVector childMin = min + FIntVector(i & 1, (i >> 1) & 1, (i >> 2) & 1) * half;
+		Nodes.Emplace(childMin, half);
+		Nodes.Last().bOutsideWorld = IsOutsideWorld(childMin, half);
+	}
+
+	Nodes[NodeIndex].FirstChild = firstChild;
+}
+
+bool FDonSparseVoxelOctree::IsInsideWorld(const FIntVector& Min, int32 Size) const
+{
+	return Min.X + Size <= GridSize.X && Min.Y + Size <= GridSize.Y && Min.Z + Size <= GridSize.Z;
+}
+
+bool FDonSparseVoxelOctree::IsOutsideWorld(const FIntVector& Min, int32 Size) const
+{
+	return Min.X >= GridSize.X || Min.Y >= GridSize.Y || Min.Z >= GridSize.Z;
+}
+
+int32 FDonSparseVoxelOctree::LeafAt(const FIntVector& Coords) const
+{
+	if (!IsValid() || (uint32)Coords.X >= (uint32)GridSize.X || (uint32)Coords.Y >= (uint32)GridSize.Y || (uint32)Coords.Z >= (uint32)GridSize.Z)
+		return INDEX_NONE;
+
+	int32 nodeIndex = 0;
+
+	while (!Nodes[nodeIndex].IsLeaf())
+	{
+		const auto& node = Nodes[nodeIndex];
+		const int32 half = node.Size / 2;
+		const int32 child = (Coords.X >= node.Min.X + half ? 1 : 0) | (Coords.Y >= node.Min.Y + half ? 2 : 0) | (Coords.Z >= node.Min.Z + half ? 4 : 0);
+
+		nodeIndex = node.FirstChild + child;
+	}
+
+	return Nodes[nodeIndex].bOutsideWorld ? INDEX_NONE : nodeIndex;
+}
+
+void FDonSparseVoxelOctree::GetFaceNeighbors(int32 NodeIndex, TArray<int32>& OutNeighbors) const
+{
+	const auto& node = Nodes[NodeIndex];
+
+	for (int32 axis = 0; axis < 3; axis++)
+	{
+		for (int32 direction = -1; direction <= 1; direction += 2)
+		{
+			// The neighbors across this face are the leaves overlapping a one-voxel thick slab just outside of it:
+			FIntVector regionMin = node.Min;
+			FIntVector regionMax = node.Min + FIntVector(node.Size);
+
+			regionMin[axis] = direction < 0 ? node.Min[axis] - 1 : node.Min[axis] + node.Size;
+			regionMax[axis] = regionMin[axis] + 1;
+
+			if (regionMin[axis] < 0 || regionMin[axis] >= GridSize[axis])
+				continue;
+
+			GatherLeavesInRegion(0, regionMin, regionMax, OutNeighbors);
+		}
+	}
+}
+
+void FDonSparseVoxelOctree::GatherLeavesInRegion(int32 NodeIndex, const FIntVector& RegionMin, const FIntVector& RegionMax, TArray<int32>& OutLeaves) const
+{
+	const auto& node = Nodes[NodeIndex];
+
+	const bool bIntersects = node.Min.X < RegionMax.X && node.Min.X + node.Size > RegionMin.X
+						  && node.Min.Y < RegionMax.Y && node.Min.Y + node.Size > RegionMin.Y
+						  && node.Min.Z < RegionMax.Z && node.Min.Z + node.Size > RegionMin.Z;
+
+	if (!bIntersects)
+		return;
+
+	if (node.IsLeaf())
+	{
+		if (!node.bOutsideWorld)
+			OutLeaves.Add(NodeIndex);
+
+		return;
+	}
+
+	for (int32 i = 0; i < 8; i++)
+		GatherLeavesInRegion(node.FirstChild + i, RegionMin, RegionMax, OutLeaves);
+}
+
+void FDonSparseVoxelOctree::GetLeavesInNode(int32 NodeIndex, TArray<int32>& OutLeaves) const
+{
+	const auto& node = Nodes[NodeIndex];
+
+	GatherLeavesInRegion(NodeIndex, node.Min, node.Min + FIntVector(node.Size), OutLeaves);
+}
+
+bool FDonSparseVoxelOctree::SplitToVoxel(const FIntVector& Coords)
+{
+	int32 nodeIndex = LeafAt(Coords);
+	if (nodeIndex == INDEX_NONE || Nodes[nodeIndex].Size == 1)
+		return false;
+
+	while (Nodes[nodeIndex].Size > 1)
+	{
+		Subdivide(nodeIndex);
+
+		const auto& node = Nodes[nodeIndex];
+		const int32 half = node.Size / 2;
+		const int32 child = (Coords.X >= node.Min.X + half ? 1 : 0) | (Coords.Y >= node.Min.Y + half ? 2 : 0) | (Coords.Z >= node.Min.Z + half ? 4 : 0);
+
+		nodeIndex = node.FirstChild + child;
+	}
+
+	return true;
+}
+
+FVector FDonSparseVoxelOctree::PortalBetween(const FDonSparseVoxelOctreeNode& A, const FDonSparseVoxelOctreeNode& B)
+{
+	FVector portal;
+
+	for (int32 axis = 0; axis < 3; axis++)
+	{
+		const int32 aMax = A.Min[axis] + A.Size;
+		const int32 bMax = B.Min[axis] + B.Size;
+
+		if (aMax == B.Min[axis])
+			portal[axis] = aMax;
+		else if (bMax == A.Min[axis])
+			portal[axis] = A.Min[axis];
+		else
+			portal[axis] = (FMath::Max(A.Min[axis], B.Min[axis]) + FMath::Min(aMax, bMax)) * 0.5f;
+	}
+
+	return portal;
+}
+
+bool FDonSparseVoxelOctree::AreFaceAdjacent(const FDonSparseVoxelOctreeNode& A, const FDonSparseVoxelOctreeNode& B)
+{
+	int32 touchingAxes = 0;
+
+	for (int32 axis = 0; axis < 3; axis++)
+	{
+		const int32 aMax = A.Min[axis] + A.Size;
+		const int32 bMax = B.Min[axis] + B.Size;
+
+		if (aMax == B.Min[axis] || bMax == A.Min[axis])
+			touchingAxes++;
+		else if (aMax < B.Min[axis] || bMax < A.Min[axis])
+			return false;
+	}
+
+	// Exactly one touching axis with overlap on the remaining two means the nodes share part of a face (rather than an edge or a corner)
+	return touchingAxes == 1;
+}
+
+int32 FDonSparseVoxelOctree::NumLeaves() const
+{
+	int32 numLeaves = 0;
+
+	for (const auto& node : Nodes)
+	{
+		if (node.IsLeaf() && !node.bOutsideWorld)
+			numLeaves++;
+	}
+
+	return numLeaves;
+}
@@ -0,0 +1,114 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "DonVoxelCollisionProfileStore.h"
+#include "DonAINavigationPrivatePCH.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/BufferArchive.h"
+#include "Serialization/MemoryReader.h"
+
+bool FDonVoxelCollisionProfileStore::ReadFile(const FString& Filename, TMap<FString, TArray<FVector>>& OutProfiles)
+{
+	TArray<uint8> fileData;
+	if (!FFileHelper::LoadFileToArray(fileData, *Filename, FILEREAD_Silent))
+		return false;
+
+	FMemoryReader reader(fileData);
+
+	uint32 magic = 0;
+	int32 version = 0;
+	reader << magic << version;
+
+	if (magic != Magic || version != Version)
+	{
+		UE_LOG(DoNNavigationLog, Warning, TEXT("Ignoring voxel collision profile cache %s written by an incompatible version"), *Filename);
+		return false;
+	}
+
+	reader << OutProfiles;
+
+	return !reader.IsError();
+}
+
+bool FDonVoxelCollisionProfileStore::Load(const FString& Filename)
+{
+	TMap<FString, TArray<FVector>> profilesOnDisk;
+	if (!ReadFile(Filename, profilesOnDisk))
+		return false;
+
+	FScopeLock scopeLock(&Lock);
+
+	// Entries sampled during this session take precedence:
+	for (auto& profile : profilesOnDisk)
+	{
+		if (!Profiles.Contains(profile.Key))
+			Profiles.Add(profile.Key, MoveTemp(profile.Value));
+	}
+
+	return true;
+}
+
+bool FDonVoxelCollisionProfileStore::Save(const FString& Filename)
+{
+	FScopeLock scopeLock(&Lock);
+
+	if (!bIsDirty)
+		return true;
+
+	TMap<FString, TArray<FVector>> profilesToSave;
+	ReadFile(Filename, profilesToSave);
+	profilesToSave.Append(Profiles);
+
+	FBufferArchive writer;
+
+	uint32 magic = Magic;
+	int32 version = Version;
+	writer << magic << version << profilesToSave;
+
+	if (!FFileHelper::SaveArrayToFile(writer, *Filename))
+		return false;
+
+	bIsDirty = false;
+
+	return true;
+}
+
+bool FDonVoxelCollisionProfileStore::Find(const FString& Key, TArray<FVector>& OutRelativeVoxelOccupancy)
+{
+	FScopeLock scopeLock(&Lock);
+
+	auto profile = Profiles.Find(Key);
+	if (!profile)
+		return false;
+
+	OutRelativeVoxelOccupancy = *profile;
+
+	return true;
+}
+
+void FDonVoxelCollisionProfileStore::Add(const FString& Key, const TArray<FVector>& RelativeVoxelOccupancy)
+{
+	FScopeLock scopeLock(&Lock);
+
+	Profiles.Add(Key, RelativeVoxelOccupancy);
+	bIsDirty = true;
+}
+
+int32 FDonVoxelCollisionProfileStore::Num()
+{
+	FScopeLock scopeLock(&Lock);
+
+	return Profiles.Num();
+}
@@ -0,0 +1,159 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "DonVoxelOccupancyCache.h"
+#include "DonAINavigationPrivatePCH.h"
+
+bool FDonVoxelOccupancyCache::Find(const FIntVector& Coords, bool& bOutIsBlocked)
+{
+	FScopeLock lock(&Lock);
+
+	RotateGenerationsIfNeeded();
+
+	if (const bool* bIsBlocked = Current.Find(Coords))
+	{
+		bOutIsBlocked = *bIsBlocked;
+		return true;
+	}
+
+	bool bIsBlocked = false;
+	if (!Previous.RemoveAndCopyValue(Coords, bIsBlocked))
+		return false;
+
+	// Still in use, so it survives the next rotation:
+	Current.Add(Coords, bIsBlocked);
+	RotateGenerationsIfNeeded();
+
+	bOutIsBlocked = bIsBlocked;
+	return true;
+}
+
+uint32 FDonVoxelOccupancyCache::GetInvalidationEpoch() const
+{
+	FScopeLock lock(&Lock);
+
+	return InvalidationEpoch;
+}
+
+void FDonVoxelOccupancyCache::Add(const FIntVector& Coords, bool bIsBlocked, uint32 Epoch)
+{
+	FScopeLock lock(&Lock);
+
+	// The geometry may have changed while this voxel was being tested:
+	if (Epoch != InvalidationEpoch)
+		return;
+
+	Current.Add(Coords, bIsBlocked);
+	RotateGenerationsIfNeeded();
+}
+
+void FDonVoxelOccupancyCache::InvalidateRegion(const FIntVector& Min, const FIntVector& Max)
+{
+	FScopeLock lock(&Lock);
+
+	InvalidationEpoch++;
+
+	const int64 regionVolume = int64(Max.X - Min.X + 1) * int64(Max.Y - Min.Y + 1) * int64(Max.Z - Min.Z + 1);
+	if (regionVolume <= 0)
+		return;
+
+	// Walk whichever is smaller, the region or the cache:
+	if (regionVolume <= Current.Num() + Previous.Num())
+	{
+		for (int32 x = Min.X; x <= Max.X; x++)
+		{
+			for (int32 y = Min.Y; y <= Max.Y; y++)
+			{
+				for (int32 z = Min.Z; z <= Max.Z; z++)
+				{
+					const FIntVector coords(x, y, z);
+					Current.Remove(coords);
+					Previous.Remove(coords);
+				}
+			}
+		}
+	}
+	else
+	{
+		auto isInRegion = [&Min, &Max](const FIntVector& Coords)
+		{
+			return Coords.X >= Min.X && Coords.X <= Max.X && Coords.Y >= Min.Y && Coords.Y <= Max.Y && Coords.Z >= Min.Z && Coords.Z <= Max.Z;
+		};
+
+		for (auto it = Current.CreateIterator(); it; ++it)
+		{
+			if (isInRegion(it.Key()))
+				it.RemoveCurrent();
+		}
+
+		for (auto it = Previous.CreateIterator(); it; ++it)
+		{
+			if (isInRegion(it.Key()))
+				it.RemoveCurrent();
+		}
+	}
+}
+
+void FDonVoxelOccupancyCache::Empty()
+{
+	FScopeLock lock(&Lock);
+
+	InvalidationEpoch++;
+
+	Current.Empty();
+	Previous.Empty();
+	CurrentGenerationStartTime = FPlatformTime::Seconds();
+}
+
+int32 FDonVoxelOccupancyCache::Num() const
+{
+	FScopeLock lock(&Lock);
+
+	return Current.Num() + Previous.Num();
+}
+
+void FDonVoxelOccupancyCache::SetLimits(int32 MaxEntriesIn, float MaxAgeSecondsIn)
+{
+	FScopeLock lock(&Lock);
+
+	MaxEntries = FMath::Max(MaxEntriesIn, 0);
+	MaxAgeSeconds = FMath::Max(MaxAgeSecondsIn, 0.f);
+
+	RotateGenerationsIfNeeded();
+}
+
+void FDonVoxelOccupancyCache::RotateGenerationsIfNeeded()
+{
+	const double now = FPlatformTime::Seconds();
+
+	if (CurrentGenerationStartTime == 0.0)
+		CurrentGenerationStartTime = now;
+
+	// Each generation holds at most half the budget, so both together never exceed it:
+	const bool bIsFull = MaxEntries > 0 && Current.Num() >= FMath::Max(MaxEntries / 2, 1);
+	const bool bIsStale = MaxAgeSeconds > 0.f && now - CurrentGenerationStartTime >= MaxAgeSeconds;
+
+	if (!bIsFull && !bIsStale)
+		return;
+
+	Previous = MoveTemp(Current);
+	Current.Reset();
+
+	// (an idle cache may have aged past both generations at once)
+	if (MaxAgeSeconds > 0.f && now - CurrentGenerationStartTime >= MaxAgeSeconds * 2.f)
+		Previous.Empty();
+
+	CurrentGenerationStartTime = now;
+}
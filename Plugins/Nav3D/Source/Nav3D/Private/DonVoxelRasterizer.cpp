@@ -0,0 +1,249 @@
+// The MIT License(MIT)
+//
+// Copyright(c) 2015 Venugopalan Sreedharan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "DonVoxelRasterizer.h"
+#include "DonAINavigationPrivatePCH.h"
+#include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+
+static float SquaredDistanceToBox(const FVector& Point, const FVector& BoxCenter, float HalfExtent)
+{
+	const FVector delta = (Point - BoxCenter).GetAbs() - FVector(HalfExtent);
+
+	return FVector(FMath::Max(delta.X, 0.f), FMath::Max(delta.Y, 0.f), FMath::Max(delta.Z, 0.f)).SizeSquared();
+}
+
+bool FDonVoxelRasterizer::CapturePrimitives(UPrimitiveComponent* Component, TArray<FDonCollisionPrimitive>& OutPrimitives)
+{
+	if (!Component)
+		return false;
+
+	const FQuat rotation = Component->GetComponentQuat();
+	const FVector scale = Component->GetComponentScale();
+
+	FDonCollisionPrimitive primitive;
+	primitive.Rotation = rotation;
+
+	// Shape components:
+	if (auto box = Cast<UBoxComponent>(Component))
+	{
+		primitive.Type = EDonCollisionPrimitiveType::Box;
+		primitive.Extent = box->GetScaledBoxExtent();
+		OutPrimitives.Add(primitive);
+
+		return true;
+	}
+	else if (auto sphere = Cast<USphereComponent>(Component))
+	{
+		primitive.Type = EDonCollisionPrimitiveType::Sphere;
+		primitive.Extent = FVector(sphere->GetScaledSphereRadius(), 0.f, 0.f);
+		OutPrimitives.Add(primitive);
+
+		return true;
+	}
+	else if (auto capsule = Cast<UCapsuleComponent>(Component))
+	{
+		primitive.Type = EDonCollisionPrimitiveType::Capsule;
+		primitive.Extent = FVector(capsule->GetScaledCapsuleRadius(), 0.f, capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere());
+		OutPrimitives.Add(primitive);
+
+		return true;
+	}
+
+	// Meshes with simple collision only:
+	auto bodySetup = Component->GetBodySetup();
+	if (!bodySetup || bodySetup->CollisionTraceFlag == CTF_UseComplexAsSimple)
+		return false;
+
+	const auto& geometry = bodySetup->AggGeom;
+	if (geometry.ConvexElems.Num() || geometry.GetElementCount() == 0 || geometry.GetElementCount() != geometry.BoxElems.Num() + geometry.SphereElems.Num() + geometry.SphylElems.Num())
+		return false;
+
+	// Non-uniform scale turns rotated boxes, spheres and capsules into shapes we can't describe exactly:
+	const bool bUniformScale = scale.AllComponentsEqual(KINDA_SMALL_NUMBER);
+	const float uniformScale = FMath::Abs(scale.X);
+
+	const int32 numCaptured = OutPrimitives.Num();
+
+	for (const auto& element : geometry.BoxElems)
+	{
+		const FQuat elementRotation = element.Rotation.Quaternion();
+		if (!bUniformScale && !elementRotation.Equals(FQuat::Identity))
+		{
+			OutPrimitives.SetNum(numCaptured);
+			return false;
+		}
+
+		primitive.Type = EDonCollisionPrimitiveType::Box;
+		primitive.Center = rotation.RotateVector(element.Center * scale);
+		primitive.Rotation = rotation * elementRotation;
+		primitive.Extent = (FVector(element.X, element.Y, element.Z) * 0.5f * scale).GetAbs();
+		OutPrimitives.Add(primitive);
+	}
+
+	for (const auto& element : geometry.SphereElems)
+	{
+		if (!bUniformScale)
+		{
+			OutPrimitives.SetNum(numCaptured);
+			return false;
+		}
+
+		primitive.Type = EDonCollisionPrimitiveType::Sphere;
+		primitive.Center = rotation.RotateVector(element.Center * scale);
+		primitive.Rotation = rotation;
+		primitive.Extent = FVector(element.Radius * uniformScale, 0.f, 0.f);
+		OutPrimitives.Add(primitive);
+	}
+
+	for (const auto& element : geometry.SphylElems)
+	{
+		if (!bUniformScale)
+		{
+			OutPrimitives.SetNum(numCaptured);
+			return false;
+		}
+
+		primitive.Type = EDonCollisionPrimitiveType::Capsule;
+		primitive.Center = rotation.RotateVector(element.Center * scale);
+		primitive.Rotation = rotation * element.Rotation.Quaternion();
+		primitive.Extent = FVector(element.Radius, 0.f, element.Length * 0.5f) * uniformScale;
+		OutPrimitives.Add(primitive);
+	}
+
+	return true;
+}
+
+FVector FDonVoxelRasterizer::GetPrimitiveExtent(const FDonCollisionPrimitive& Primitive)
+{
+	switch (Primitive.Type)
+	{
+	case EDonCollisionPrimitiveType::Box:
+	{
+		const FVector axisX = Primitive.Rotation.GetAxisX() * Primitive.Extent.X;
+		const FVector axisY = Primitive.Rotation.GetAxisY() * Primitive.Extent.Y;
+		const FVector axisZ = Primitive.Rotation.GetAxisZ() * Primitive.Extent.Z;
+
+		return axisX.GetAbs() + axisY.GetAbs() + axisZ.GetAbs();
+	}
+	case EDonCollisionPrimitiveType::Sphere:
+		return FVector(Primitive.Extent.X);
+
+	case EDonCollisionPrimitiveType::Capsule:
+		return (Primitive.Rotation.GetAxisZ() * Primitive.Extent.Z).GetAbs() + FVector(Primitive.Extent.X);
+	}
+
+	return FVector::ZeroVector;
+}
+
+bool FDonVoxelRasterizer::Overlaps(const FDonCollisionPrimitive& Primitive, const FVector& VoxelCenter, float HalfVoxel)
+{
+	switch (Primitive.Type)
+	{
+	case EDonCollisionPrimitiveType::Box:
+	{
+		// Separating axis test on the face normals of both boxes. The nine edge-edge axes are skipped, which can only ever err on the side of overlapping.
+		const FVector delta = VoxelCenter - Primitive.Center;
+		const FVector axes[3] = { Primitive.Rotation.GetAxisX(), Primitive.Rotation.GetAxisY(), Primitive.Rotation.GetAxisZ() };
+
+		for (int32 worldAxis = 0; worldAxis < 3; worldAxis++)
+		{
+			const float radius = Primitive.Extent.X * FMath::Abs(axes[0][worldAxis]) + Primitive.Extent.Y * FMath::Abs(axes[1][worldAxis]) + Primitive.Extent.Z * FMath::Abs(axes[2][worldAxis]);
+			if (FMath::Abs(delta[worldAxis]) > radius + HalfVoxel)
+				return false;
+		}
+
+		for (int32 boxAxis = 0; boxAxis < 3; boxAxis++)
+		{
+			const float radius = HalfVoxel * (FMath::Abs(axes[boxAxis].X) + FMath::Abs(axes[boxAxis].Y) + FMath::Abs(axes[boxAxis].Z));
+			if (FMath::Abs(FVector::DotProduct(delta, axes[boxAxis])) > Primitive.Extent[boxAxis] + radius)
+				return false;
+		}
+
+		return true;
+	}
+	case EDonCollisionPrimitiveType::Sphere:
+		return SquaredDistanceToBox(Primitive.Center, VoxelCenter, HalfVoxel) <= FMath::Square(Primitive.Extent.X);
+
+	case EDonCollisionPrimitiveType::Capsule:
+	{
+		// The distance from a box to points along the capsule's segment is convex, so a ternary search finds the closest point
+		const FVector halfSegment = Primitive.Rotation.GetAxisZ() * Primitive.Extent.Z;
+		const FVector start = Primitive.Center - halfSegment;
+		const FVector segment = halfSegment * 2.f;
+
+		float low = 0.f, high = 1.f;
+
+		for (int32 iteration = 0; iteration < 24; iteration++)
+		{
+			const float a = low + (high - low) / 3.f;
+			const float b = high - (high - low) / 3.f;
+
+			if (SquaredDistanceToBox(start + segment * a, VoxelCenter, HalfVoxel) <= SquaredDistanceToBox(start + segment * b, VoxelCenter, HalfVoxel))
+				high = b;
+			else
+				low = a;
+		}
+
+		return SquaredDistanceToBox(start + segment * ((low + high) * 0.5f), VoxelCenter, HalfVoxel) <= FMath::Square(Primitive.Extent.X);
+	}
+	}
+
+	return false;
+}
+
+void FDonVoxelRasterizer::Rasterize(const TArray<FDonCollisionPrimitive>& Primitives, const FVector& PivotOffset, float VoxelSize, TArray<FVector>& OutRelativeVoxelOccupancy)
+{
+	if (VoxelSize <= 0.f)
+		return;
+
+	const float halfVoxel = VoxelSize / 2;
+
+	TSet<FIntVector> occupied;
+
+	for (const auto& primitive : Primitives)
+	{
+		// Voxel N spans [N * VoxelSize - PivotOffset - halfVoxel, N * VoxelSize - PivotOffset + halfVoxel] relative to the component origin
+		const FVector extent = GetPrimitiveExtent(primitive);
+		const FVector min = (primitive.Center - extent + PivotOffset) / VoxelSize;
+		const FVector max = (primitive.Center + extent + PivotOffset) / VoxelSize;
+
+		const FIntVector minVoxel(FMath::CeilToInt(min.X - 0.5f), FMath::CeilToInt(min.Y - 0.5f), FMath::CeilToInt(min.Z - 0.5f));
+		const FIntVector maxVoxel(FMath::FloorToInt(max.X + 0.5f), FMath::FloorToInt(max.Y + 0.5f), FMath::FloorToInt(max.Z + 0.5f));
+
+		for (int32 x = minVoxel.X; x <= maxVoxel.X; x++)
+		{
+			for (int32 y = minVoxel.Y; y <= maxVoxel.Y; y++)
+			{
+				for (int32 z = minVoxel.Z; z <= maxVoxel.Z; z++)
+				{
+					const FIntVector voxel(x, y, z);
+					if (occupied.Contains(voxel))
+						continue;
+
+					if (Overlaps(primitive, FVector(voxel) * VoxelSize - PivotOffset, halfVoxel))
+						occupied.Add(voxel);
+				}
+			}
+		}
+	}
+
+	OutRelativeVoxelOccupancy.Reserve(OutRelativeVoxelOccupancy.Num() + occupied.Num());
+
+	for (const auto& voxel : occupied)
+		OutRelativeVoxelOccupancy.Add(FVector(voxel));
+}
@@ -61,6 +61,15 @@ uint32 FDonNavigationWorker::Run()
 
 	while (StopTaskCounter.GetValue() == 0)
 	{
+		// Stay out of the grid lock while idle so that the game thread gets a chance to evict cold voxel bricks
+		if (!Manager->HasPendingWork_WorkerThread())
+		{
+			FPlatformProcess::Sleep(0.f);
+			continue;
+		}
+
+		FScopeLock lock(&Manager->NAVVolumeDataLock);
+
 		//Manager->ReceiveAsyncAbortRequests();
 		Manager->ReceiveAsyncNavigationTasks();		
 		Manager->ReceiveAsyncCollisionTasks();